@@ -0,0 +1,200 @@
+#include "ai.h"
+
+#include "placement.h"
+
+// A cell's count is at most 2 * size * size per ship (size positions each way, each covering up to
+// size open hits), so the counters need enough bits for twice the fleet's sum of squares
+#define HEAT_MAX (2 * FLEET_SQUARES)
+#define HEAT_PLANES (HEAT_MAX < 64 ? 6 : HEAT_MAX < 128 ? 7 : HEAT_MAX < 256 ? 8 : HEAT_MAX < 512 ? 9 : 10)
+_Static_assert(HEAT_MAX < 1024, "heat counters would overflow");
+
+// Fully unroll a loop over a ship's cells (gcc and clang both read this pragma)
+#define UNROLL_SHIP _Pragma("GCC unroll 16")
+
+/**
+ * heat struct, stores a counter for every cell, bit-sliced: plane[p] holds bit p of every count
+ */
+typedef struct heat {
+    bitboard_t plane[HEAT_PLANES];
+} heat_t;
+
+/**
+ * Add one to the counter of every cell set in cells (a ripple-carry add across the planes)
+ */
+static inline void heat_add(heat_t* heat, bitboard_t cells) {
+    for (int p = 0; p < HEAT_PLANES && !bb_empty(cells); p++) {
+        bitboard_t carry = bb_and(heat->plane[p], cells);
+        heat->plane[p] = bb_xor(heat->plane[p], cells);
+        cells = carry;
+    }
+}
+
+/**
+ * Count the positions of one ship that avoid the blocked cells. Always inlined with a constant
+ * size, so the offset loops unroll into fixed shifts.
+ *
+ * @param table The ship's placement table
+ * @param size  The ship's size
+ * @param heat  The counters to add to
+ * @param free  Cells a ship can be on
+ * @param open  Hits not known to belong to a sunk ship, or an empty bitboard to hunt
+ */
+static inline __attribute__((always_inline)) void count_ship(const placementTable_t* table, int size, heat_t* heat,
+                                                             bitboard_t free, bitboard_t open) {
+    bool target = !bb_empty(open);
+
+    _Pragma("GCC unroll 2")
+    for (int orientation = HORIZONTAL; orientation <= VERTICAL; orientation++) {
+        int step = orientation == VERTICAL ? NCOLS : 1;
+
+        // Every start cell whose whole ship lies on free cells
+        bitboard_t starts = table->starts[orientation];
+        UNROLL_SHIP
+        for (int k = 0; k < size; k++) {
+            starts = bb_and(starts, bb_shr(free, k * step));
+        }
+        if (bb_empty(starts)) continue;
+
+        if (!target) {
+            // Each position covers its start cell and the size - 1 cells after it
+            UNROLL_SHIP
+            for (int k = 0; k < size; k++) heat_add(heat, bb_shl(starts, k * step));
+            continue;
+        }
+        for (int j = 0; j < size; j++) {
+            // Positions whose j-th cell is an open hit
+            bitboard_t through = bb_and(starts, bb_shr(open, j * step));
+            if (bb_empty(through)) continue;
+            UNROLL_SHIP
+            for (int k = 0; k < size; k++) heat_add(heat, bb_shl(through, k * step));
+        }
+    }
+}
+
+/**
+ * Count the positions of every ship still afloat that avoid the blocked cells. With open hits,
+ * only positions covering at least one of them count, once per open hit they cover. The fleet is
+ * unrolled from the ruleset, so every ship is counted with its size known at compile time.
+ *
+ * @param ai      The AI
+ * @param heat    The counters to fill in (zeroed first)
+ * @param blocked Cells no ship can be on: misses and pinned-down sunk ships
+ * @param open    Hits not known to belong to a sunk ship, or an empty bitboard to hunt
+ */
+static void count_positions(const ai_t* ai, heat_t* heat, bitboard_t blocked, bitboard_t open) {
+    *heat = (heat_t){0};
+    bitboard_t free = bb_andnot(bb_all(), blocked);
+    int i = 0;
+
+#define COUNT_SHIP(name, size) \
+    if (ai->sunkAt[i] == NO_SHIP_INDEX) count_ship(placements_for_size(size), size, heat, free, open); \
+    i++;
+    FLEET(COUNT_SHIP)
+#undef COUNT_SHIP
+}
+
+/**
+ * Narrow candidates down to the cells with the highest count
+ *
+ * @param heat       The counters
+ * @param candidates The cells to choose from
+ * @return The busiest candidates, or candidates itself if all their counts are 0
+ */
+static bitboard_t busiest(const heat_t* heat, bitboard_t candidates) {
+    for (int p = HEAT_PLANES - 1; p >= 0; p--) {
+        bitboard_t top = bb_and(candidates, heat->plane[p]);
+        if (!bb_empty(top)) candidates = top;
+    }
+    return candidates;
+}
+
+/**
+ * Check whether any candidate has a non-zero count
+ */
+static bool any_heat(const heat_t* heat, bitboard_t candidates) {
+    bitboard_t any = {{0}};
+    for (int p = 0; p < HEAT_PLANES; p++) any = bb_or(any, heat->plane[p]);
+    return !bb_empty(bb_and(any, candidates));
+}
+
+/**
+ * Work out which cells each sunk ship covered, where the hits leave only one possibility. Pinning
+ * one ship can settle another, so this repeats until nothing changes.
+ *
+ * @param ai The AI
+ */
+static void pin_sunk_ships(ai_t* ai) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        bitboard_t open = bb_andnot(ai->hit, ai->sunk);
+        for (int i = 0; i < NDIFSHIPS; i++) {
+            if (ai->sunkAt[i] == NO_SHIP_INDEX || ai->pinned[i]) continue;
+
+            // Positions through the sinking shot whose cells are all unclaimed hits
+            const placementTable_t* table = placements_for_ship(i);
+            int size = shipArray[i].size;
+            int x = ai->sunkAt[i] % NCOLS + 1;
+            int y = ai->sunkAt[i] / NCOLS + 1;
+            const placement_t* only = NULL;
+            int matches = 0;
+            for (int k = 0; k < size; k++) {
+                int entries[2] = {NO_PLACEMENT, NO_PLACEMENT};
+                if (x - k >= 1) entries[0] = table->index[HORIZONTAL][bb_index(x - k, y)];
+                if (y - k >= 1 && size > 1) entries[1] = table->index[VERTICAL][bb_index(x, y - k)];
+                for (int e = 0; e < 2; e++) {
+                    if (entries[e] == NO_PLACEMENT) continue;
+                    const placement_t* placement = &table->placements[entries[e]];
+                    if (bb_empty(bb_andnot(placement->mask, open))) {
+                        only = placement;
+                        matches++;
+                    }
+                }
+            }
+
+            if (matches == 1) {
+                ai->sunk = bb_or(ai->sunk, only->mask);
+                ai->pinned[i] = true;
+                changed = true;
+                open = bb_andnot(ai->hit, ai->sunk);
+            }
+        }
+    }
+}
+
+// Start an AI for a new game
+void ai_init(ai_t* ai, uint64_t seed) {
+    *ai = (ai_t){0};
+    for (int i = 0; i < NDIFSHIPS; i++) ai->sunkAt[i] = NO_SHIP_INDEX;
+    rng_seed(&ai->rng, seed);
+}
+
+// Pick the next cell to shoot at
+void ai_choose_shot(ai_t* ai, int* x, int* y) {
+    bitboard_t candidates = bb_andnot(bb_all(), ai->guessed);
+    bitboard_t blocked = bb_or(bb_andnot(ai->guessed, ai->hit), ai->sunk);
+    bitboard_t open = bb_andnot(ai->hit, ai->sunk);
+
+    // Finish off damaged ships first; hunt if there are none (or no afloat ship fits the hits)
+    heat_t heat;
+    count_positions(ai, &heat, blocked, open);
+    if (bb_empty(open) || !any_heat(&heat, candidates)) {
+        count_positions(ai, &heat, blocked, (bitboard_t){{0}});
+    }
+
+    bitboard_t best = busiest(&heat, candidates);
+    int cell = bb_select(best, rng_below(&ai->rng, bb_count(best)));
+    *x = cell % NCOLS + 1;
+    *y = cell / NCOLS + 1;
+}
+
+// Tell the AI what one of its shots did
+void ai_record_shot(ai_t* ai, int x, int y, guess_result_t result, int ship) {
+    bb_set(&ai->guessed, x, y);
+    if (result != GUESS_HIT && result != GUESS_SUNK) return;
+    bb_set(&ai->hit, x, y);
+    if (result == GUESS_SUNK && ship >= 0 && ship < NDIFSHIPS) {
+        ai->sunkAt[ship] = bb_index(x, y);
+        pin_sunk_ships(ai);
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * Computer opponent - a hunt/target player driven by a probability heatmap.
+ *
+ * Before every shot the AI counts, for each cell, how many positions of the ships still afloat
+ * would cover it and are consistent with everything it has seen: no position may cross a miss or
+ * a sunk ship. While it has hits that don't belong to a sunk ship it only counts positions that
+ * run through them (weighted by how many they cover), so it finishes off damaged ships; otherwise
+ * it shoots where the most positions overlap.
+ *
+ * The counting never visits a placement one at a time. For each ship and orientation, the
+ * precomputed start-cell masks (placement.h) are ANDed with the free cells shifted by each ship
+ * offset, giving every consistent position at once as a bitboard; those are shifted back and
+ * added into bit-sliced per-cell counters (one bitboard per bit of the count), and the busiest
+ * cell is found by walking the counter planes from the top. A decision takes a few hundred bitboard
+ * operations and no per-cell loops.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "rng.h"
+
+/**
+ * ai struct, stores what the AI has learned about the opponent's board
+ */
+typedef struct ai {
+    bitboard_t guessed;             // cells we've shot at
+    bitboard_t hit;                 // ... and the ones that hit
+    bitboard_t sunk;                // cells of sunk ships we've pinned down
+    int16_t sunkAt[NDIFSHIPS];      // bit index of the shot that sank each ship, or NO_SHIP_INDEX
+    bool pinned[NDIFSHIPS];         // whether each sunk ship's cells are known
+    rng_t rng;                      // breaks ties between equally likely cells
+} ai_t;
+
+/**
+ * Start an AI for a new game
+ *
+ * @param ai   The AI
+ * @param seed Seed for its tie-breaking (the same seed and replies give the same shots)
+ */
+void ai_init(ai_t* ai, uint64_t seed);
+
+/**
+ * Pick the next cell to shoot at
+ *
+ * @param ai The AI
+ * @param x  Set to the column, 1..NCOLS
+ * @param y  Set to the row, 1..NROWS
+ */
+void ai_choose_shot(ai_t* ai, int* x, int* y);
+
+/**
+ * Tell the AI what one of its shots did
+ *
+ * @param ai     The AI
+ * @param x      Column of the shot
+ * @param y      Row of the shot
+ * @param result GUESS_MISS, GUESS_HIT, or GUESS_SUNK
+ * @param ship   With GUESS_SUNK, index in shipArray of the ship that sank
+ */
+void ai_record_shot(ai_t* ai, int x, int y, guess_result_t result, int ship);
@@ -5,14 +5,64 @@
 #include "battleship.h"
 
 size_t cursor = INIT_CURSOR;
-int BUFFSIZE = 32;
+
+//when set, the fleet and attacks come from this script instead of the keyboard and nothing is drawn
+static script_t* script = NULL;
+
+//when set, the computer plays this side: it places a random fleet, picks its own attacks, and nothing is drawn
+static ai_t* ai = NULL;
+
+//when set, the computer picks its attacks by Monte Carlo sampling on these threads instead of the heatmap
+static mc_pool_t* mc_pool = NULL;
+static uint64_t mc_budget_ns;           // sampling time per attack
+static unsigned long mc_fleets, mc_moves;   // fleets sampled and attacks chosen, for the report
+
+//fast mode: nothing waits on the clock (always on for scripted and computer players)
+static bool fast = false;
 
 int main(int argc, char *argv[]){
 
     // Validate command-line arguments
     if (argc < 2) {
-        fprintf(stderr, "Usage: %s <role> [<server_name> <port>]\n", argv[0]);
-        fprintf(stderr, "Role: server or client\n");
+        fprintf(stderr, "Usage: %s <role> [<server_name> <port>] [--fast] [--script <file>] [--ai | --ai-mc <ms>]\n", argv[0]);
+        fprintf(stderr, "Role: server, client, host [<port> [epoll|uring [<players>]]], or watch <host> <port>\n");
+        fprintf(stderr, "--fast skips the pauses between screens and reports start-up and tear-down times\n");
+        fprintf(stderr, "--script plays server or client from a file (\"-\" for stdin) without a terminal\n");
+        fprintf(stderr, "--ai has the computer play the server's side, for a game against the computer\n");
+        fprintf(stderr, "--ai-mc is a stronger computer that samples possible fleets on every core for <ms> per attack\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Options for server or client come after the positional arguments
+    const char* script_path = NULL;
+    bool fast_mode = false;
+    bool computer = false;
+    unsigned mc_budget_ms = 0;
+    while (argc >= 3) {
+        if (strcmp(argv[argc - 1], "--fast") == 0) {
+            fast_mode = true;
+            argc -= 1;
+        } else if (strcmp(argv[argc - 1], "--ai") == 0) {
+            computer = true;
+            argc -= 1;
+        } else if (strcmp(argv[argc - 2], "--ai-mc") == 0) {
+            computer = true;
+            mc_budget_ms = atoi(argv[argc - 1]);
+            if (mc_budget_ms == 0) {
+                fprintf(stderr, "--ai-mc needs a time per attack in milliseconds.\n");
+                exit(EXIT_FAILURE);
+            }
+            argc -= 2;
+        } else if (strcmp(argv[argc - 2], "--script") == 0) {
+            script_path = argv[argc - 1];
+            argc -= 2;
+        } else {
+            break;
+        }
+    }
+
+    if (computer && script_path != NULL) {
+        fprintf(stderr, "--ai (or --ai-mc) and --script can't be used together.\n");
         exit(EXIT_FAILURE);
     }
 
@@ -20,22 +70,47 @@ int main(int argc, char *argv[]){
     if (strcmp(argv[1], "server") == 0) {
         unsigned short port = 0;    // Initialize the port
         printf("Starting server...\n");
-        run_server(port);
+        run_server(port, script_path, fast_mode, computer, mc_budget_ms);
     } 
     // Check if the user wants to start as a client
     else if (strcmp(argv[1], "client") == 0) {
         if (argc < 4) {
-            fprintf(stderr, "Usage for client: %s client <server_name> <port>\n", argv[0]);
+            fprintf(stderr, "Usage for client: %s client <server_name> <port> [--script <file>]\n", argv[0]);
             exit(EXIT_FAILURE);
         }
         char *server_name = argv[2];
         unsigned short port = atoi(argv[3]);
         printf("Connecting to server %s on port %u...\n", server_name, port);
-        run_client(server_name, port);
+        run_client(server_name, port, script_path, fast_mode);
     } 
+    // Check if the user wants to host many matches between connecting clients
+    else if (strcmp(argv[1], "host") == 0) {
+        unsigned short port = (argc >= 3) ? atoi(argv[2]) : 0;
+        server_backend_t backend = BACKEND_EPOLL;
+        if (argc >= 4 && strcmp(argv[3], "uring") == 0) {
+            backend = BACKEND_URING;
+        } else if (argc >= 4 && strcmp(argv[3], "epoll") != 0) {
+            fprintf(stderr, "Invalid backend. Use 'epoll' or 'uring'.\n");
+            exit(EXIT_FAILURE);
+        }
+        int players = (argc >= 5) ? atoi(argv[4]) : 2;
+        if (players < 2 || players > MAX_SEATS) {
+            fprintf(stderr, "Invalid number of players. Use 2 to %d.\n", MAX_SEATS);
+            exit(EXIT_FAILURE);
+        }
+        run_match_server(port, backend, players);
+    }
+    // Check if the user wants to watch a match host's games
+    else if (strcmp(argv[1], "watch") == 0) {
+        if (argc < 4) {
+            fprintf(stderr, "Usage for watch: %s watch <host> <port>\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+        run_spectator(argv[2], atoi(argv[3]));
+    }
     // Invalid role provided
     else {
-        fprintf(stderr, "Invalid role. Use 'server' or 'client'.\n");
+        fprintf(stderr, "Invalid role. Use 'server', 'client', 'host', or 'watch'.\n");
         exit(EXIT_FAILURE);
     }
 
@@ -45,535 +120,985 @@ int main(int argc, char *argv[]){
 }
 
 /**
- * Initializes the server-side (Player 1) logic for the game 
- * and then runs the game from the server side
- * 
- * @param port The port number the server will listen on
- */ 
-void run_server(unsigned short port) {
-    //open server socket
-    int server_socket_fd = server_socket_open(&port);
-    if (server_socket_fd == -1) {
-        perror("Failed to open server socket");
-        exit(EXIT_FAILURE);
-    }
+ * Check whether this side plays without a screen (a script or the computer is playing it)
+ */
+static bool headless() {
+    return script != NULL || ai != NULL;
+}
 
-    // Start listening for incoming connections
-    printf("Server listening on port %u\n", port);
-    if (listen(server_socket_fd, 1) == -1) {
-        perror("Failed to listen on server socket");
-        close(server_socket_fd);
-        exit(EXIT_FAILURE);
-    }
 
-    // Accept a client connection
-    int client_socket_fd = server_socket_accept(server_socket_fd);
-    if (client_socket_fd == -1) {
-        perror("Failed to accept client connection");
-        close(server_socket_fd);
-        exit(EXIT_FAILURE);
+/**
+ * Give the player time to read the screen. Nothing waits in fast mode.
+ *
+ * @param seconds How long to wait
+ */
+static void pause_for_player(unsigned seconds) {
+    if (!fast) sleep(seconds);
+}
+
+
+/**
+ * Tell the player their opponent left the match (see player_leave)
+ *
+ * @param prompt_win The curses window for displaying prompts
+ */
+static void opponent_quit(WINDOW* prompt_win) {
+    if (headless()) printf("Your opponent rage quit. You win!\n");
+    render_print(prompt_win, cursor++, 1, "Your opponent rage quit. You win!");
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Your opponent rage quit. You win!");
+    pause_for_player(2);
+}
+
+
+/**
+ * Record the result of our attack on our view of the opponent's board, and tell the player how
+ * it went
+ *
+ * @param their_board Our view of the board we shot at
+ * @param result      The RESULT frame for our attack
+ * @param prompt_win  The curses window for displaying prompts
+ */
+static void record_attack_result(board_t* their_board, const frame_t* result, WINDOW* prompt_win) {
+    int x = result->x;
+    int y = result->y;
+
+    //handle case that we already guessed this location
+    bool alreadyGuessed = false;
+    if(bb_test(&their_board->guessed, x, y)) alreadyGuessed=true;
+
+    board_mark_guess(their_board, x, y, result->outcome != RESULT_MISS);
+    //if we hit
+    if (result->outcome != RESULT_MISS) {
+        render_print(prompt_win, cursor++, 1, "You hit a ship at %c,%d!", x + 'A' - 1, y);
+        free(most_recent_prompt);
+        int strlength = strlen("You hit a ship at  , !") + 3 + 1;
+        most_recent_prompt = malloc(sizeof(char)*strlength);
+        sprintf(most_recent_prompt, "You hit a ship at %c,%d!", x + 'A' - 1, y);
     }
-    printf("Player 2 connected!\n");
-    sleep(1);
+    //if we sunk a ship
+    if (result->outcome == RESULT_SUNK) {
+        //update their fleet table with the ship we sunk
+        char * sunkShipName = shipArray[result->ship].name;
+        board_mark_sunk(their_board, result->ship);
+        render_print(prompt_win, cursor++, 1, "You sunk their %s at %c,%d!", sunkShipName, x + 'A' - 1, y);
+        free(most_recent_prompt);
+        int strlength = strlen("You sunk their at  , !") + 3 + 1 + strlen(sunkShipName);
+        most_recent_prompt = malloc(sizeof(char)*strlength);
+        sprintf(most_recent_prompt, "You sunk their %s at %c,%d!", sunkShipName, x + 'A' - 1, y);
+    }
+    //if we missed
+    if (result->outcome == RESULT_MISS) {
+        if(alreadyGuessed){
+            render_print(prompt_win, cursor++, 1, "You already guessed %c,%d. You lose a turn!", x + 'A' - 1, y);
+            free(most_recent_prompt);
+            int strlength = strlen("You already guessed  , . You lose a turn!") + 3 + 1;
+            most_recent_prompt = malloc(sizeof(char)*strlength);
+            sprintf(most_recent_prompt, "You already guessed %c,%d. You lose a turn!", x + 'A' - 1, y);
+        }else{
+            render_print(prompt_win, cursor++, 1, "You missed at %c,%d.", x + 'A' - 1, y);
+            free(most_recent_prompt);
+            int strlength = strlen("You missed at  , .") + 3 + 1;
+            most_recent_prompt = malloc(sizeof(char)*strlength);
+            sprintf(most_recent_prompt, "You missed at %c,%d.", x + 'A' - 1, y);
+        }
+    }
+}
 
-    // Initialize curses for graphics
-    init_curses();
 
-    // Create graphical windows for the boards
-    WINDOW* player_win = create_board_window(1, 1, "Your Board");
-    WINDOW* opponent_win = create_board_window(1, 40, "Opponent's Board");
-    WINDOW* prompt_win = create_prompt_window(16, 1);
+/**
+ * Plays Player 1's or Player 2's attack for one turn: reads the attack coordinates from the user,
+ * sends them to the opponent, and records the result on our view of their board.
+ *
+ * @param session           Our connection to the opponent (or the match host)
+ * @param their_board       Our view of the opponent's board
+ * @param opponent_win      The curses window for the opponent's board
+ * @param prompt_win        The curses window for displaying prompts
+ * @return true if the game continues, false if we won or lost the connection
+ */
+static bool attack_turn(session_t* session, board_t* their_board, WINDOW* opponent_win, WINDOW* prompt_win) {
+    msg_conn_t* conn = &session->conn;
+    int seat = session->seat;
+    int attack_coords[2];
+    int x, y;
 
-    // Reset the cursor before tracking
-    cursor = INIT_CURSOR;   
-    start_cursor_tracking(prompt_win);
+    render_print(prompt_win, cursor++, 1, "Your turn to attack!\n");
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Your turn to attack!\n");
+
+    // Get attack coords from the computer, the script, or the user
+    if (mc_pool != NULL) {
+        mc_fleets += mc_choose_shot(mc_pool, ai, mc_budget_ns, &x, &y);
+        mc_moves++;
+    } else if (ai != NULL) {
+        ai_choose_shot(ai, &x, &y);
+    } else if (script != NULL) {
+        int player;     // only matters with more than two players
+        if (!script_next_attack(script, &x, &y, &player)) {
+            // Out of attacks: leave the match so the opponent isn't left waiting
+            frame_t quit = {.type = MSG_QUIT, .seat = seat, .ship = NO_SHIP};
+            send_frame(conn->fd, &quit);
+            printf("Script ended, leaving the match.\n");
+            return false;
+        }
+    } else {
+        free(most_recent_prompt);
+        memcpy(attack_coords, validCoords(attack_coords, prompt_win, "Please input attack coordinates (ex: A,1): \0"), 2*sizeof(int));
+        x = attack_coords[0];  // Row index
+        y = attack_coords[1];  // Column index
+    }
 
-    // Display welcome message
-    welcome_message(prompt_win);
+    // Send attack coords to the opponent
+    frame_t attack = {.type = MSG_ATTACK, .seat = seat, .target = 1 - seat, .x = x, .y = y, .ship = NO_SHIP};
+    send_frame(conn->fd, &attack);
+    session_turn(session);
 
-    /*Initialize game boards for both players
-        though we only have access to the p1 data, we can update
-        our vision of the p2 board based on our guesses*/ 
-    board_t player1_board, player2_board;
-    initBoard(&player1_board);
-    initBoard(&player2_board);
+    // Receive result of the attack
+    frame_t result;
+    if (receive_frame(conn, &result) == -1) {
+        perror("Failed to receive attack result");
+        return false;
+    }
+    if (result.type == MSG_QUIT) {
+        opponent_quit(prompt_win);
+        return false;
+    }
+    if (result.type != MSG_RESULT || result.x != x || result.y != y) {
+        fprintf(stderr, "Unexpected message from opponent\n");
+        return false;
+    }
 
-    /*Initialize enemy fleet status array to all be false. They 
-      all correspond to an index in the shipArray, and will turn 
-      their values true as we sink them*/
-    bool enemyFleetStatus[NDIFSHIPS];
-    for(int i = 0; i<NDIFSHIPS; i++){
-        enemyFleetStatus[i]=false;
+    // Let the computer learn from the result
+    if (ai != NULL) {
+        guess_result_t guess = result.outcome == RESULT_SUNK ? GUESS_SUNK : (result.outcome == RESULT_HIT ? GUESS_HIT : GUESS_MISS);
+        ai_record_shot(ai, x, y, guess, result.ship);
     }
 
-    // Show the empty boards to the player
-    draw_player_board(player_win, player1_board.array);
-    draw_opponent_board(opponent_win, player2_board.array);
+    // Update the opponent's board window and our prompt window with the results
+    record_attack_result(their_board, &result, prompt_win);
+    draw_opponent_board(opponent_win, their_board);
+    return true;
+}
 
-    // Refresh the windows
-    wrefresh(player_win);
-    wrefresh(opponent_win);
 
-    // Player 1 places ships
-    mvwprintw(prompt_win, cursor++, 1, "**Place your ships**");
-    wrefresh(prompt_win);
-    player1_board = makeBoard(prompt_win, player_win);
-    printStatus(player1_board, prompt_win, "p1Board.txt");
 
-    // Update the player's board window
-    draw_player_board(player_win, player1_board.array);
+/**
+ * Plays the opponent's attack for one turn: receives their coordinates, applies them to our
+ * board, and reports the result back.
+ *
+ * @param session        Our connection to the opponent (or the match host)
+ * @param my_board       This player's board
+ * @param opponent_name  Name of the opponent used in prompts ("Player 1" or "Player 2")
+ * @param player_win     The curses window for this player's board
+ * @param prompt_win     The curses window for displaying prompts
+ * @return true if the game continues, false if we lost the connection
+ */
+static bool defend_turn(session_t* session, board_t* my_board, const char* opponent_name, WINDOW* player_win, WINDOW* prompt_win) {
+    msg_conn_t* conn = &session->conn;
+    int seat = session->seat;
+    render_print(prompt_win, cursor++, 1, "Waiting for %s's attack...\n", opponent_name);
+    free(most_recent_prompt);
+    most_recent_prompt = malloc(strlen("Waiting for 's attack...\n") + strlen(opponent_name) + 1);
+    sprintf(most_recent_prompt, "Waiting for %s's attack...\n", opponent_name);
+
+    // Receive attack from the opponent
+    frame_t attack;
+    if (receive_frame(conn, &attack) == -1) {
+        perror("Failed to receive enemy attack");
+        return false;
+    }
+    if (attack.type == MSG_QUIT) {
+        opponent_quit(prompt_win);
+        return false;
+    }
+    if (attack.type != MSG_ATTACK) {
+        fprintf(stderr, "Unexpected message from opponent\n");
+        return false;
+    }
+    session_turn(session);
+    int x = attack.x;
+    int y = attack.y;
+
+    // Update our board with the attack results
+    bool hit, sunk;
+    updateBoardAfterGuess(my_board, x, y, &hit, &sunk, prompt_win);
+
+    // Send attack result to the opponent, naming the ship (by shipArray index) if it sank
+    frame_t result = {.type = MSG_RESULT, .seat = attack.seat, .target = seat, .x = x, .y = y,
+                      .outcome = sunk ? RESULT_SUNK : (hit ? RESULT_HIT : RESULT_MISS), .ship = NO_SHIP};
+    if(sunk) result.ship = board_ship_at(my_board, x, y);
+    send_frame(conn->fd, &result);
+
+    //update our board
+    draw_player_board(player_win, my_board);
+    return true;
+}
 
-    // Notify the client that the server is ready
-    send_message(client_socket_fd, "READY");
-    sleep(1);
 
-    // Wait for the client to finish placing ships
-    mvwprintw(prompt_win, cursor++, 1, "Waiting for opponent to place ships...");
-    wrefresh(prompt_win);
-    char* message = receive_message(client_socket_fd);
-    if (strcmp(message, "READY") != 0) {
-        printf("Client not ready. Exiting.\n");
-        free(message);
-        close(client_socket_fd);
-        close(server_socket_fd);
-        end_curses();
-        exit(EXIT_FAILURE);
+/**
+ * Tells the player how the game ended and waits (up to 5 seconds, or until a key is pressed)
+ * before the windows go away.
+ *
+ * @param prompt_win     The curses window for displaying prompts
+ * @param outcome        How the game ended
+ * @param opponent_name  Name of the opponent used in prompts
+ */
+static void show_game_over(WINDOW* prompt_win, victory_t outcome, const char* opponent_name) {
+    if (outcome == VICTORY_NONE) return;
+
+    // In fast mode the result is printed once the screen is gone (see report_game_over)
+    if (fast) return;
+
+    sleep(1);
+    render_erase(prompt_win);
+    render_box(prompt_win);
+    cursor = INIT_CURSOR;
+    if (outcome == VICTORY_WON) {
+        render_print(prompt_win, cursor++, 1, "Congratulations, you win!");
     } else {
-        wrefresh(prompt_win);
-        mvwprintw(prompt_win, cursor++, 1, "Opponent is ready! Starting game...");
-        wrefresh(prompt_win);
-        free(message);
-        sleep(1);
+        render_print(prompt_win, cursor++, 1, "You lost...%s wins!", opponent_name);
     }
+    render_print(prompt_win, cursor++, 1, "Press any key to exit.");
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Press any key to exit.");
 
-    // Start victory tracking thread
-    start_victory_tracking(&player1_board, &player2_board, prompt_win);
+    render_getch_timeout(5000);
+}
 
-    // Main game loop
-    bool game_running = true;
-    while (game_running) {
-        int attack_coords[2];
-        int x, y;
 
-        // Player 1's turn
-        mvwprintw(prompt_win, cursor++, 1, "Your turn to attack!\n");
-        free(most_recent_prompt);
-        most_recent_prompt = strdup("Your turn to attack!\n");
-        wrefresh(prompt_win);
+/**
+ * Print how the game ended, and how long start-up and tear-down took, once the screen is gone.
+ * Only in fast mode, where show_game_over doesn't wait for the player to read the result.
+ *
+ * @param session        Our closed connection
+ * @param outcome        How the game ended
+ * @param opponent_name  Name of the opponent
+ */
+static void report_game_over(const session_t* session, victory_t outcome, const char* opponent_name) {
+    if (!fast) return;
+    if (outcome == VICTORY_WON) {
+        printf("Congratulations, you win!\n");
+    } else if (outcome == VICTORY_LOST) {
+        printf("You lost...%s wins!\n", opponent_name);
+    }
+    session_print_timing(session, stdout);
+    if (mc_moves > 0) {
+        printf("Monte Carlo: %lu possible fleets sampled per attack\n", mc_fleets / mc_moves);
+    }
+}
 
-        // Get attack coords from user
-        free(most_recent_prompt);
-        memcpy(attack_coords, validCoords(attack_coords, prompt_win, "Please input attack coordinates (ex: A,1): \0"), 2*sizeof(int));
-        x = attack_coords[0];  // Row index
-        y = attack_coords[1];  // Column index
 
-        // Prepare coords to send to client
-        char attack_coords_char[3];
-        for (int i = 0; i < 2; i++){
-            attack_coords_char[i] = (attack_coords[i] == 10) ? '0' : attack_coords[i] + '0';
+/**
+ * Runs the turn loop of a match once both players have placed their ships. The player who
+ * attacks first alternates with the opponent until somebody wins or the connection drops.
+ *
+ * @param session        Our connection to the opponent (or the match host); its seat 0 shoots first
+ * @param opponent_name  Name of the opponent used in prompts
+ * @param my_board       This player's board
+ * @param their_board    Our view of the opponent's board
+ * @param player_win     The curses window for this player's board
+ * @param opponent_win   The curses window for the opponent's board
+ * @param prompt_win     The curses window for displaying prompts
+ */
+static void play_game(session_t* session, const char* opponent_name, board_t* my_board, board_t* their_board,
+                      WINDOW* player_win, WINDOW* opponent_win, WINDOW* prompt_win) {
+    // Main game loop, until somebody's fleet is destroyed or the connection drops
+    bool my_turn = session->seat == 0;
+    while (session->state == SESSION_PLAYING) {
+        check_cursor();
+        bool game_running;
+        if (my_turn) {
+            game_running = attack_turn(session, their_board, opponent_win, prompt_win);
+        } else {
+            game_running = defend_turn(session, my_board, opponent_name, player_win, prompt_win);
         }
-        attack_coords_char[2] = '\0';
+        if (!game_running || victory_reached()) session_over(session);
+        my_turn = !my_turn;
+    }
+}
 
-        // Send attack coords to client
-        send_message(client_socket_fd, attack_coords_char);
 
+/**
+ * ffa struct, stores what a player knows about a match with more than two players
+ */
+typedef struct ffa {
+    int players;
+    int attacker;               // seat whose attack comes next
+    int left;                   // seats still in the match
+    bool out[MAX_SEATS];        // seats whose fleet is gone or whose player left
+    board_t views[MAX_SEATS];   // our view of every other seat's board, from the results we've heard
+} ffa_t;
 
-        /*Expected format of the incoming attack result message:
-          [hitSUNKircraft Carrier]
-          [mmmrrrrnnnnnnnnnnnnnnnn]
-          [hit or miss // sunk or empty // name of ship hit or empty]*/
-        // Receive result of the attack
-        char* attack_result = receive_message(client_socket_fd);
-        if (!attack_result) {
-            perror("Failed to receive attack result");
-            game_running = false;
-            break;
-        }
 
-        //handle case that we already guessed this location
-        bool alreadyGuessed = false;
-        if(player2_board.array[x][y].guessed) alreadyGuessed=true;
+/**
+ * Tell the player somebody is out of a match with more than two players. Scripted players get it
+ * on stdout as well.
+ *
+ * @param prompt_win The curses window for displaying prompts
+ * @param format     printf-style message
+ */
+static void ffa_announce(WINDOW* prompt_win, const char* format, ...) {
+    char message[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (headless()) printf("%s\n", message);
+    render_print(prompt_win, cursor++, 1, "%s", message);
+    free(most_recent_prompt);
+    most_recent_prompt = strdup(message);
+}
 
-        // Update the opponent's board window and our prompt window with the results
-        player2_board.array[x][y].guessed = true;
-        //if we hit
-        if (strstr(attack_result, "HIT") != NULL) {
-            player2_board.array[x][y].hit = true;
-            mvwprintw(prompt_win, cursor++, 1, "You hit a ship at %c,%d!", x + 'A' - 1, y);
-            free(most_recent_prompt);
-            int strlength = strlen("You hit a ship at  , !") + 3 + 1;
-            most_recent_prompt = malloc(sizeof(char)*strlength);
-            sprintf(most_recent_prompt, "You hit a ship at %c,%d!", x + 'A' - 1, y);
-        }
-        //if we sunk a ship
-        if (strstr(attack_result, "sunk")!= NULL) {
-            player2_board.array[x][y].hit = true;
-            char * sunkShipName="NULL";
-            //update our array keeping track of which ships of theirs we've sunk
-            for(int i = 0; i<NDIFSHIPS; i++){
-                if(strstr(attack_result, shipArray[i].name)!=NULL) {
-                    sunkShipName = shipArray[i].name;
-                    enemyFleetStatus[i]=true;
-                }
-            }
-            mvwprintw(prompt_win, cursor++, 1, "You sunk their %s at %c,%d!", sunkShipName, x + 'A' - 1, y);
-            free(most_recent_prompt);
-            int strlength = strlen("You sunk their at  , !") + 3 + 1 + strlen(sunkShipName);
-            most_recent_prompt = malloc(sizeof(char)*strlength);
-            sprintf(most_recent_prompt, "You sunk their %s at %c,%d!", sunkShipName, x + 'A' - 1, y);
+
+/**
+ * Find the seat that attacks after another one, the same way the host does
+ *
+ * @param ffa  The match, with at least one other seat still in it
+ * @param seat The seat that just attacked (it may be out by now)
+ * @return The next seat in order that is still in the match
+ */
+static int ffa_next_seat(const ffa_t* ffa, int seat) {
+    do {
+        seat = (seat + 1) % ffa->players;
+    } while (ffa->out[seat]);
+    return seat;
+}
+
+
+/**
+ * Take a seat out of the match because its last ship sank or its player left. If it was their
+ * turn to attack, the next seat attacks instead; if we're the only one left, we win.
+ *
+ * @param session    Our connection to the match host
+ * @param ffa        The match
+ * @param seat       The seat that is out
+ * @param left       true if the player left, false if their fleet is gone
+ * @param prompt_win The curses window for displaying prompts
+ */
+static void ffa_eliminate(session_t* session, ffa_t* ffa, int seat, bool left, WINDOW* prompt_win) {
+    if (ffa->out[seat]) return;
+    ffa->out[seat] = true;
+    ffa->left--;
+
+    if (left) {
+        ffa_announce(prompt_win, "Player %d left the match.", seat + 1);
+        if (seat == ffa->attacker) ffa->attacker = ffa_next_seat(ffa, seat);
+    } else {
+        ffa_announce(prompt_win, "Player %d's fleet is gone!", seat + 1);
+    }
+    if (ffa->left == 1 && !ffa->out[session->seat]) declare_victory();
+}
+
+
+/**
+ * Finish a turn once its result is known: the target is out if that was its last ship, and the
+ * next seat still in the match attacks
+ *
+ * @param session    Our connection to the match host
+ * @param ffa        The match
+ * @param target     The seat that was attacked
+ * @param prompt_win The curses window for displaying prompts
+ */
+static void ffa_end_turn(session_t* session, ffa_t* ffa, int target, WINDOW* prompt_win) {
+    if (ffa->views[target].shipsSunk == NDIFSHIPS) ffa_eliminate(session, ffa, target, false, prompt_win);
+    ffa->attacker = ffa_next_seat(ffa, ffa->attacker);
+}
+
+
+/**
+ * Record the result of somebody else's attack on our view of the target's board, and finish that
+ * turn. The late result of an attack whose attacker has left still counts, but the turn already
+ * moved on when they left.
+ *
+ * @param session      Our connection to the match host
+ * @param ffa          The match
+ * @param frame        The RESULT frame
+ * @param opponent_win The curses window for the opponent's board
+ * @param prompt_win   The curses window for displaying prompts
+ */
+static void ffa_follow_result(session_t* session, ffa_t* ffa, const frame_t* frame, WINDOW* opponent_win,
+                              WINDOW* prompt_win) {
+    board_t* view = &ffa->views[frame->target];
+    board_mark_guess(view, frame->x, frame->y, frame->outcome != RESULT_MISS);
+    char col = frame->x + 'A' - 1;
+    if (frame->outcome == RESULT_SUNK) {
+        board_mark_sunk(view, frame->ship);
+        render_print(prompt_win, cursor++, 1, "Player %d sunk Player %d's %s at %c,%d!", frame->seat + 1,
+                     frame->target + 1, shipArray[frame->ship].name, col, frame->y);
+    } else {
+        render_print(prompt_win, cursor++, 1, "Player %d %s Player %d at %c,%d.", frame->seat + 1,
+                     frame->outcome == RESULT_HIT ? "hit" : "missed", frame->target + 1, col, frame->y);
+    }
+    draw_opponent_board(opponent_win, view);
+
+    if (!ffa->out[frame->seat]) {
+        ffa_end_turn(session, ffa, frame->target, prompt_win);
+    } else if (view->shipsSunk == NDIFSHIPS) {
+        ffa_eliminate(session, ffa, frame->target, false, prompt_win);
+    }
+}
+
+
+/**
+ * Plays our attack in a match with more than two players: picks who to attack and where, from the
+ * script or the user, sends the attack, and records the result on our view of that player's board.
+ * If the target leaves (or its last ship sinks) before answering, the turn is still ours.
+ *
+ * @param session      Our connection to the match host
+ * @param ffa          The match
+ * @param opponent_win The curses window for the opponent's board
+ * @param prompt_win   The curses window for displaying prompts
+ * @return true if the game continues, false if we won, left, or lost the connection
+ */
+static bool ffa_attack_turn(session_t* session, ffa_t* ffa, WINDOW* opponent_win, WINDOW* prompt_win) {
+    msg_conn_t* conn = &session->conn;
+    int seat = session->seat;
+    int x, y, target;
+
+    render_print(prompt_win, cursor++, 1, "Your turn to attack!\n");
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Your turn to attack!\n");
+
+    // Get the target and the attack coords from the script or the user
+    if (script != NULL) {
+        int player;
+        if (!script_next_attack(script, &x, &y, &player)) {
+            // Out of attacks: leave the match so the others aren't left waiting
+            frame_t quit = {.type = MSG_QUIT, .seat = seat, .ship = NO_SHIP};
+            send_frame(conn->fd, &quit);
+            printf("Script ended, leaving the match.\n");
+            return false;
         }
-        //if we missed
-        if (strstr(attack_result, "MISS") != NULL) {
-            if(alreadyGuessed){
-                mvwprintw(prompt_win, cursor++, 1, "You already guessed %c,%d. You lose a turn!", x + 'A' - 1, y);
-                free(most_recent_prompt);
-                int strlength = strlen("You already guessed  , . Opponent's turn.") + 3 + 1;
-                most_recent_prompt = malloc(sizeof(char)*strlength);
-                sprintf(most_recent_prompt, "You already guessed %c,%d. You lose a turn!", x + 'A' - 1, y);
-            }else{
-                mvwprintw(prompt_win, cursor++, 1, "You missed at %c,%d.", x + 'A' - 1, y);
-                free(most_recent_prompt);
-                int strlength = strlen("You missed at  , .") + 3 + 1;
-                most_recent_prompt = malloc(sizeof(char)*strlength);
-                sprintf(most_recent_prompt, "You missed at %c,%d.", x + 'A' - 1, y);
-            }
+        // Unless the script names somebody still in, attack the next player after us
+        target = ffa_next_seat(ffa, seat);
+        if (player >= 1 && player <= ffa->players && player - 1 != seat && !ffa->out[player - 1]) target = player - 1;
+    } else {
+        bool inGame[MAX_SEATS];
+        char players[3 * MAX_SEATS + 1] = "";
+        for (int other = 0; other < ffa->players; other++) {
+            inGame[other] = other != seat && !ffa->out[other];
+            if (inGame[other]) sprintf(players + strlen(players), " %d", other + 1);
         }
-        free(attack_result);
+        render_print(prompt_win, cursor++, 1, "Players you can attack:%s", players);
+        target = validPlayer(prompt_win, inGame, ffa->players);
+        draw_opponent_board(opponent_win, &ffa->views[target]);
+
+        int attack_coords[2];
+        free(most_recent_prompt);
+        memcpy(attack_coords, validCoords(attack_coords, prompt_win, "Please input attack coordinates (ex: A,1): \0"), 2*sizeof(int));
+        x = attack_coords[0];  // Row index
+        y = attack_coords[1];  // Column index
+    }
 
-        //check if we won
-        bool won = true;
-        for(int i = 0; i<NDIFSHIPS; i++){
-            if(!enemyFleetStatus[i]) won = false;
+    // Send attack coords to the host, which passes them on to the target
+    frame_t attack = {.type = MSG_ATTACK, .seat = seat, .target = target, .x = x, .y = y, .ship = NO_SHIP};
+    send_frame(conn->fd, &attack);
+    session_turn(session);
+
+    // Receive result of the attack; anybody leaving in the meantime is announced first, and so is
+    // the late result of an attack whose attacker left (if it sank our target's last ship, the host
+    // calls our attack off and it's still our turn)
+    frame_t result;
+    while (true) {
+        if (receive_frame(conn, &result) == -1) {
+            perror("Failed to receive attack result");
+            return false;
         }
-        if(won){
-            sleep(1);
-            werase(prompt_win);
-            box(prompt_win, 0, 0);
-            cursor = 1;
-            mvwprintw(prompt_win, cursor++, 1, "Congratulations, you win!");
-            free(most_recent_prompt);
-            most_recent_prompt = strdup("Congratulations, you win!");
-            game_running = false;
-            mvwprintw(prompt_win, cursor++, 1, "Exiting...");
-            free(most_recent_prompt);
-            most_recent_prompt = strdup("Exiting...");
-            wrefresh(prompt_win);
-            sleep(5);
+        if (result.type == MSG_RESULT && result.seat != seat && result.seat < ffa->players && ffa->out[result.seat]) {
+            ffa_follow_result(session, ffa, &result, opponent_win, prompt_win);
+            if (victory_reached() || ffa->out[target]) return true;
             continue;
         }
+        if (result.type != MSG_QUIT) break;
+        ffa_eliminate(session, ffa, result.seat, true, prompt_win);
+        if (victory_reached() || result.seat == target) return true;
+    }
+    if (result.type != MSG_RESULT || result.target != target || result.x != x || result.y != y) {
+        fprintf(stderr, "Unexpected message from the host\n");
+        return false;
+    }
 
-        //refresh our opponent board with results
-        draw_opponent_board(opponent_win, player2_board.array);
-        wrefresh(prompt_win);
+    record_attack_result(&ffa->views[target], &result, prompt_win);
+    draw_opponent_board(opponent_win, &ffa->views[target]);
+    ffa_end_turn(session, ffa, target, prompt_win);
+    return true;
+}
 
-        // Player 2's turn
-        mvwprintw(prompt_win, cursor++, 1, "Waiting for Player 2's attack...\n");
-        free(most_recent_prompt);
-        most_recent_prompt = strdup("Waiting for Player 2's attack...\n");
-        wrefresh(prompt_win);
-
-        // Receive attack from client
-        char* enemy_attack_string = receive_message(client_socket_fd);
-        if (!enemy_attack_string) {
-            perror("Failed to receive enemy attack");
-            game_running = false;
-            break;
-        }
 
-        // Convert received coords to ints
-        int p2_attack_int[2];
-        p2_attack_int[0] = (enemy_attack_string[0] == '0') ? 10 : enemy_attack_string[0] - '0';
-        p2_attack_int[1] = (enemy_attack_string[1] == '0') ? 10 : enemy_attack_string[1] - '0'; 
-        free(enemy_attack_string);
+/**
+ * Waits out somebody else's attack in a match with more than two players. An attack on us is
+ * answered from our board; the result of an attack on anybody else is recorded on our view of
+ * their board.
+ *
+ * @param session      Our connection to the match host
+ * @param ffa          The match
+ * @param my_board     This player's board
+ * @param player_win   The curses window for this player's board
+ * @param opponent_win The curses window for the opponent's board
+ * @param prompt_win   The curses window for displaying prompts
+ * @return true if the game continues, false if we lost the connection
+ */
+static bool ffa_watch_turn(session_t* session, ffa_t* ffa, board_t* my_board, WINDOW* player_win,
+                           WINDOW* opponent_win, WINDOW* prompt_win) {
+    msg_conn_t* conn = &session->conn;
+    int seat = session->seat;
+    render_print(prompt_win, cursor++, 1, "Waiting for Player %d's attack...\n", ffa->attacker + 1);
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Waiting for the next attack...\n");
+
+    frame_t frame;
+    if (receive_frame(conn, &frame) == -1) {
+        perror("Failed to receive enemy attack");
+        return false;
+    }
 
-        // Update Player 1's board with attack results
+    if (frame.type == MSG_QUIT) {
+        ffa_eliminate(session, ffa, frame.seat, true, prompt_win);
+        return true;
+    }
+
+    if (frame.type == MSG_ATTACK) {
+        // We're the target: update our board and send the result back
+        session_turn(session);
         bool hit, sunk;
-        updateBoardAfterGuess(&player1_board, p2_attack_int[0], p2_attack_int[1], &hit, &sunk, prompt_win);
+        updateBoardAfterGuess(my_board, frame.x, frame.y, &hit, &sunk, prompt_win);
+        frame_t result = {.type = MSG_RESULT, .seat = frame.seat, .target = seat, .x = frame.x, .y = frame.y,
+                          .outcome = sunk ? RESULT_SUNK : (hit ? RESULT_HIT : RESULT_MISS), .ship = NO_SHIP};
+        if(sunk) result.ship = board_ship_at(my_board, frame.x, frame.y);
+        send_frame(conn->fd, &result);
+        draw_player_board(player_win, my_board);
+        ffa->attacker = ffa_next_seat(ffa, ffa->attacker);
+        return true;
+    }
+
+    if (frame.type == MSG_RESULT && frame.target != seat) {
+        // Somebody else was attacked: follow their board
+        session_turn(session);
+        ffa_follow_result(session, ffa, &frame, opponent_win, prompt_win);
+        return true;
+    }
+
+    fprintf(stderr, "Unexpected message from the host\n");
+    return false;
+}
 
-        //get sunkShipName if player sunk a ship
-        char* sunkShip = "NULL";
-        if(sunk){
-            sunkShip = player1_board.array[p2_attack_int[0]][p2_attack_int[1]].ship.name;
-        }
 
-        // Send attack result to Player 2
-        /*Format of the outoging attack result message:
-          [hitSUNKircraft Carrier]
-          [mmmrrrrnnnnnnnnnnnnnnnn]
-          [hit or miss // sunk or empty // name of ship hit or empty]*/
-        char result_message[BUFFSIZE];
-        snprintf(result_message, sizeof(result_message), "%s%s%s", hit ? "HIT" : "MISS", sunk ? " (sunk)" : "", sunkShip);
-        send_message(client_socket_fd, result_message);
+/**
+ * Runs the turn loop of a match with more than two players once everybody has placed their ships.
+ * Seats attack in order, skipping anybody who is out, until one is left or the connection drops.
+ *
+ * @param session      Our connection to the match host; its seat 0 shoots first
+ * @param my_board     This player's board
+ * @param player_win   The curses window for this player's board
+ * @param opponent_win The curses window for the board of whoever was attacked last
+ * @param prompt_win   The curses window for displaying prompts
+ */
+static void play_ffa(session_t* session, board_t* my_board, WINDOW* player_win, WINDOW* opponent_win,
+                     WINDOW* prompt_win) {
+    ffa_t ffa = {.players = session->players, .attacker = 0, .left = session->players};
+    for (int seat = 0; seat < ffa.players; seat++) {
+        initBoard(&ffa.views[seat]);
+    }
 
-        //update our opponent board
-        draw_player_board(player_win, player1_board.array);
-        wrefresh(prompt_win);
+    while (session->state == SESSION_PLAYING) {
+        check_cursor();
+        bool game_running;
+        if (ffa.attacker == session->seat) {
+            game_running = ffa_attack_turn(session, &ffa, opponent_win, prompt_win);
+        } else {
+            game_running = ffa_watch_turn(session, &ffa, my_board, player_win, opponent_win, prompt_win);
+        }
+        if (!game_running || victory_reached()) session_over(session);
     }
+}
 
-    // Stop the tracking threads
-    stop_victory_tracking();
-    stop_cursor_tracking();
-    
-    // Close sockets and end curses
-    close(client_socket_fd);
-    close(server_socket_fd);
-    end_curses();
+
+/**
+ * Open the script a scripted player reads from; interactive players (path NULL) don't have one
+ *
+ * @param path    The script file, "-" for stdin, or NULL to play from the keyboard
+ * @param storage Where to keep the open script
+ */
+static void open_script(const char* path, script_t* storage) {
+    script = NULL;
+    if (path == NULL) return;
+    fast = true;
+    if (script_open(storage, path) == -1) {
+        perror("Failed to open script");
+        exit(EXIT_FAILURE);
+    }
+    script = storage;
 }
 
 
 /**
- * Initializes the client-side (Player 2) logic for the game
- * 
- * @param server_name The IP or hostname of the server
- * @param port        The port number the server is listening on.
+ * Let the computer play this side (see ai.h), optionally with Monte Carlo sampling on every core
+ * (see montecarlo.h)
+ *
+ * @param storage   Where to keep the computer's state
+ * @param budget_ms Sampling time per attack, or 0 to use the heatmap
  */
-void run_client(char* server_name, unsigned short port) {
-    // Connect to the server
-    int socket_fd = socket_connect(server_name, port);
-    if (socket_fd == -1) {
-        perror("Failed to connect to server");
+static void start_ai(ai_t* storage, unsigned budget_ms) {
+    fast = true;
+    uint64_t seed = ((uint64_t)time(NULL) << 20) ^ getpid();
+    ai_init(storage, seed);
+    ai = storage;
+    if (budget_ms == 0) return;
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    mc_pool = mc_pool_create(cores > 0 ? cores : 1, seed);
+    if (mc_pool == NULL) {
+        perror("Failed to start the Monte Carlo threads");
         exit(EXIT_FAILURE);
     }
-    printf("Connected to Player 1!\n");
-    sleep(1);
+    mc_budget_ns = (uint64_t)budget_ms * 1000000;
+    printf("Computer samples fleets on %ld threads for %u ms per attack\n", cores > 0 ? cores : 1, budget_ms);
+}
+
+
+/**
+ * Stop the Monte Carlo threads, if the computer was using them
+ */
+static void stop_ai() {
+    if (mc_pool != NULL) mc_pool_destroy(mc_pool);
+    mc_pool = NULL;
+}
+
+
+/**
+ * Set up the screen: curses, the board and prompt windows, the render thread, and the welcome
+ * message. Scripted and computer players have no screen, so their windows are left NULL (drawing
+ * without the render thread does nothing).
+ *
+ * @param player_win   Set to the window for this player's board
+ * @param opponent_win Set to the window for the opponent's board
+ * @param prompt_win   Set to the window for displaying prompts
+ */
+static void start_screen(WINDOW** player_win, WINDOW** opponent_win, WINDOW** prompt_win) {
+    *player_win = *opponent_win = *prompt_win = NULL;
+    if (headless()) return;
 
     // Initialize curses for graphics
     init_curses();
 
     // Create graphical windows for the boards
-    WINDOW* player_win = create_board_window(1, 1, "Your Board");
-    WINDOW* opponent_win = create_board_window(1, 40, "Opponent's Board");
-    WINDOW* prompt_win = create_prompt_window(16, 1);
+    *player_win = create_board_window(1, 1, "Your Board");
+    *opponent_win = create_board_window(1, BOARD_WINDOW_COLS + 5, "Opponent's Board");
+    *prompt_win = create_prompt_window(BOARD_WINDOW_ROWS + 1, 1);
+
+    // From here on the render thread does all drawing and reads the keyboard
+    render_start();
 
-    cursor = INIT_CURSOR;   // Reset the cursor before tracking
-    start_cursor_tracking(prompt_win);
+    // Reset the cursor before tracking
+    cursor = INIT_CURSOR;
+    start_cursor_tracking(*prompt_win);
 
     // Display welcome message
-    welcome_message(prompt_win);
+    welcome_message(*prompt_win);
+}
 
-    // Initialize game boards for both players
-    board_t player2_board, player1_board;
-    initBoard(&player2_board);
-    initBoard(&player1_board);
 
-    //Initialize enemy fleet status array to all be false, will turn them true as we sink them
-    bool enemyFleetStatus[NDIFSHIPS];
-    for(int i = 0; i<NDIFSHIPS; i++){
-        enemyFleetStatus[i]=false;
+/**
+ * Tear down whatever start_screen set up, and close the script
+ */
+static void end_screen() {
+    if (!headless()) end_curses();
+    if (script != NULL) {
+        script_close(script);
+        script = NULL;
     }
+    ai = NULL;
+}
 
-    // Show the empty boards to the player
-    draw_player_board(player_win, player2_board.array);
-    draw_opponent_board(opponent_win, player1_board.array);
 
-    // Refresh the windows
-    wrefresh(player_win);
-    wrefresh(opponent_win);
+/**
+ * Place this player's fleet, at random for the computer, from the script, or by prompting the
+ * player, and show it
+ *
+ * @param my_board     Set to this player's board
+ * @param their_board  Set to an empty view of the opponent's board
+ * @param status_file  File the interactive player's board layout is written to (see printStatus)
+ * @param player_win   The curses window for this player's board
+ * @param opponent_win The curses window for the opponent's board
+ * @param prompt_win   The curses window for displaying prompts
+ * @return true once the fleet is placed, false if the script's fleet is invalid
+ */
+static bool place_fleet(board_t* my_board, board_t* their_board, const char* status_file, WINDOW* player_win,
+                        WINDOW* opponent_win, WINDOW* prompt_win) {
+    initBoard(my_board);
+    initBoard(their_board);
+    if (ai != NULL) {
+        board_random_fleet(my_board, &ai->rng);
+        return true;
+    }
+    if (script != NULL) return script_read_fleet(script, my_board) == 0;
 
-    // Player 2 places ships
-    mvwprintw(prompt_win, cursor++, 1, "**Place your ships**");
-    wrefresh(prompt_win);
-    player2_board = makeBoard(prompt_win, player_win);
-    printStatus(player2_board, prompt_win, "p2Board.txt");
+    // Show the empty boards to the player
+    draw_player_board(player_win, my_board);
+    draw_opponent_board(opponent_win, their_board);
+
+    // Place ships
+    render_print(prompt_win, cursor++, 1, "**Place your ships**");
+    *my_board = makeBoard(prompt_win, player_win);
+    printStatus(*my_board, prompt_win, (char*)status_file);
 
     // Update the player's board window
-    draw_player_board(player_win, player2_board.array);
+    draw_player_board(player_win, my_board);
+    return true;
+}
 
-    // Notify the server that the client is ready
-    send_message(socket_fd, "READY");
-    sleep(1);
 
-    // Wait for the server to finish placing ships
-    mvwprintw(prompt_win, cursor++, 1, "Waiting for opponent to place ships...");
-    wrefresh(prompt_win);
-    char* message = receive_message(socket_fd);
-    if (strcmp(message, "READY") != 0) {
-        mvwprintw(prompt_win, cursor++, 1, "Server not ready. Exiting.\n");
-        wrefresh(prompt_win);
-        free(message);
-        close(socket_fd);
-        end_curses();
-        printf("Exiting with exit failure because server was NOT ready\n.");
-        printf("'%s'\n", message);
+/**
+ * Initializes the server-side (Player 1) logic for the game
+ * and then runs the game from the server side
+ *
+ * @param port        The port number the server will listen on
+ * @param script_path Script to play from instead of the keyboard ("-" for stdin), or NULL
+ * @param fast_mode   true to skip the pauses between screens (always on with a script)
+ * @param computer    true to have the computer play Player 1 instead of a person
+ * @param mc_budget_ms With computer, Monte Carlo sampling time per attack, or 0 for the heatmap AI
+ */
+void run_server(unsigned short port, const char* script_path, bool fast_mode, bool computer, unsigned mc_budget_ms) {
+    fast = fast_mode;
+    script_t script_storage;
+    open_script(script_path, &script_storage);
+    ai_t ai_storage;
+    if (computer) start_ai(&ai_storage, mc_budget_ms);
+
+    //open server socket
+    int server_socket_fd = server_socket_open(&port);
+    if (server_socket_fd == -1) {
+        perror("Failed to open server socket");
         exit(EXIT_FAILURE);
-    } else {
-        wrefresh(prompt_win);
-        mvwprintw(prompt_win, cursor++, 1, "Opponent is ready! Starting game...");
-        wrefresh(prompt_win);
-        free(message);
-        sleep(1);
     }
 
-    // Start victory tracking thread
-    start_victory_tracking(&player1_board, &player2_board, prompt_win);
+    // Start listening for incoming connections
+    printf("Server listening on port %u\n", port);
+    fflush(stdout);
+    if (listen(server_socket_fd, 1) == -1) {
+        perror("Failed to listen on server socket");
+        close(server_socket_fd);
+        exit(EXIT_FAILURE);
+    }
 
-    // Main game loop
-    bool game_running = true;
-    while (game_running) {
-        int attack_coords[2];
-        int x, y;
+    // Accept a client connection
+    int client_socket_fd = server_socket_accept(server_socket_fd);
+    if (client_socket_fd == -1) {
+        perror("Failed to accept client connection");
+        close(server_socket_fd);
+        exit(EXIT_FAILURE);
+    }
+    printf("Player 2 connected!\n");
 
-        // Player 1's turn
-        mvwprintw(prompt_win, cursor++, 1, "Waiting for Player 1's attack...\n");
-        free(most_recent_prompt);
-        most_recent_prompt = strdup("Waiting for Player 1's attack...\n");
-        wrefresh(prompt_win);
-
-        // Receive enemy attack from player 1
-        char* enemy_attack_string = receive_message(socket_fd);
-        if (!enemy_attack_string) {
-            perror("Failed ro receive enemy attack");
-            game_running = false;
-            break;
-        }
+    // Turns are tiny messages, so don't let Nagle hold them back
+    int opt = 1;
+    setsockopt(client_socket_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    session_t session;
+    session_init(&session, client_socket_fd, 0);
+    pause_for_player(1);
 
-        // Convert received coords to ints
-        x = (enemy_attack_string[0] == '0') ? 10 : enemy_attack_string[0] - '0';
-        y = (enemy_attack_string[1] == '0') ? 10 : enemy_attack_string[1] - '0';
-        free(enemy_attack_string);
+    WINDOW *player_win, *opponent_win, *prompt_win;
+    start_screen(&player_win, &opponent_win, &prompt_win);
 
-        // Update Player 2's board based on Player 1's attack
-        bool hit, sunk;
-        updateBoardAfterGuess(&player2_board, x, y, &hit, &sunk, prompt_win);
+    /*Initialize game boards for both players
+        though we only have access to the p1 data, we can update
+        our vision of the p2 board based on our guesses*/
+    board_t player1_board, player2_board;
+    if (!place_fleet(&player1_board, &player2_board, "p1Board.txt", player_win, opponent_win, prompt_win)) {
+        session_close(&session);
+        close(server_socket_fd);
+        end_screen();
+        exit(EXIT_FAILURE);
+    }
 
-        //save name of ship they sunk
-        char* sunkShip = "NULL";
-        if(sunk){
-            sunkShip = player2_board.array[x][y].ship.name;
-        }
+    // Notify the client that the server is ready, and that the client is Player 2 (seat 1), then
+    // wait for the client to finish placing ships
+    render_print(prompt_win, cursor++, 1, "Waiting for opponent to place ships...");
+    if (session_ready(&session, 1) == -1 || session_wait_start(&session, false) == -1) {
+        session_close(&session);
+        close(server_socket_fd);
+        end_screen();
+        printf("Client not ready. Exiting.\n");
+        exit(EXIT_FAILURE);
+    }
+    render_print(prompt_win, cursor++, 1, "Opponent is ready! Starting game...");
+    pause_for_player(1);
 
-        // Send attack result to Player 1
-        /* Format of the outgoing attack result message:
-          [hitSUNKircraft Carrier]
-          [mmmrrrrnnnnnnnnnnnnnnnn]
-          [hit or miss // sunk or empty // name of ship hit or empty]*/
-        char result_message[BUFFSIZE];
-        snprintf(result_message, sizeof(result_message), "%s%s%s", hit ? "HIT" : "MISS", sunk ? " (sunk)" : "", sunkShip);
-        send_message(socket_fd, result_message);
-
-        //update our board
-        draw_player_board(player_win, player2_board.array);
-        wrefresh(prompt_win);
-        
-        // Player 2's turn
-        mvwprintw(prompt_win, cursor++, 1, "Your turn to attack\n");
-        free(most_recent_prompt);
-        most_recent_prompt = strdup("Your turn to attack\n");
-        wrefresh(prompt_win);
+    // Start victory tracking
+    start_victory_tracking(&player1_board, &player2_board);
 
-        // Get attacks coords from user
-        free(most_recent_prompt);
-        memcpy(attack_coords, validCoords(attack_coords, prompt_win, "Please input attack coordinates (ex: A,1): \0"), 2*sizeof(int));
-        x = attack_coords[0];   // Row index
-        y = attack_coords[1];   // Column index
-        
-        // Prepare coords to send to server (send_message takes chars, not ints)
-        char  attack_coords_char[3];
-        for (int i = 0; i < 2; i++){
-            attack_coords_char[i] = (attack_coords[i] == 10) ? '0' : attack_coords[i] + '0';
-        }
-        attack_coords_char[2] = '\0';
-        
-        // Send attack to Player 1
-        send_message(socket_fd, attack_coords_char);
-        
-
-        /*Expected format of the incoming attack result message:
-          [hitSUNKircraft Carrier]
-          [mmmrrrrnnnnnnnnnnnnnnnn]
-          [hit or miss // sunk or empty // name of ship hit or empty]*/
-        // Receive attack result
-        char* attack_result = receive_message(socket_fd);
-        if (!attack_result) {
-            perror("Failed to receive attack result");
-            game_running = false;
-            break;
-        }
+    // Player 1 always takes the first shot
+    play_game(&session, "Player 2", &player1_board, &player2_board, player_win, opponent_win, prompt_win);
 
-        //Handle the case that we already guessed this location
-        bool alreadyGuessed = false;
-        if(player1_board.array[x][y].guessed) alreadyGuessed=true;
+    // The turn loop only ends once there's a winner or the game can't go on, so stop tracking
+    // (which releases the wait if nobody won) and report the result
+    stop_victory_tracking();
+    victory_t outcome = wait_for_victory();
+    show_game_over(prompt_win, outcome, "Player 2");
+    stop_cursor_tracking();
 
-        // Update opponent's board based on attack result
-        player1_board.array[x][y].guessed = true;
-        //if we hit
-        if (strstr(attack_result, "HIT") != NULL) {
-            player1_board.array[x][y].hit = true;
-            mvwprintw(prompt_win, cursor++, 1, "You hit a ship at %c,%d!", x + 'A' - 1, y);
-            free(most_recent_prompt);
-            int strlength = strlen("You hit a ship at  , !") + 3 + 1;
-            most_recent_prompt = malloc(sizeof(char)*strlength);
-            sprintf(most_recent_prompt, "You hit a ship at %c,%d!", x + 'A' - 1, y);
-        } 
-        //if we sank a ship
-        if (strstr(attack_result, "sunk") != NULL) {
-            player1_board.array[x][y].hit = true;
-            char* shipWeSunk = "NULL";
-            //update our array of which ships of theirs we've sank
-            for(int i = 0; i<NDIFSHIPS; i++){
-                if(strstr(attack_result, shipArray[i].name)!=NULL) {
-                    shipWeSunk = shipArray[i].name;
-                    enemyFleetStatus[i]=true;
-                }
-            }
-            mvwprintw(prompt_win, cursor++, 1, "You sunk their %s at %c,%d!", shipWeSunk, x + 'A' - 1, y);
-            free(most_recent_prompt);
-            int strlength = strlen("You sunk their  at  , !") + 3 + 1 + strlen(shipWeSunk);
-            most_recent_prompt = malloc(sizeof(char)*strlength);
-            sprintf(most_recent_prompt, "You sunk their %s at %c,%d!", shipWeSunk, x + 'A' - 1, y);
-        }
-        //if we missed
-        if(strstr(attack_result, "MISS") != NULL) {
-            if(alreadyGuessed){
-                mvwprintw(prompt_win, cursor++, 1, "You already guessed %c,%d. Opponent's turn.", x + 'A' - 1, y);
-                free(most_recent_prompt);
-                int strlength = strlen("You already guessed  , . Opponent's turn.") + 3 + 1;
-                most_recent_prompt = malloc(sizeof(char)*strlength);
-                sprintf(most_recent_prompt, "You already guessed %c,%d. Opponent's turn.", x + 'A' - 1, y);
-            }else{
-                mvwprintw(prompt_win, cursor++, 1, "You missed at %c,%d.", x + 'A' - 1, y);
-                free(most_recent_prompt);
-                int strlength = strlen("You missed at  , !") + 3 + 1;
-                most_recent_prompt = malloc(sizeof(char)*strlength);
-                sprintf(most_recent_prompt, "You missed at %c,%d.", x + 'A' - 1, y);
-            }
-        }
-        free(attack_result);
+    // End curses and close sockets
+    end_screen();
+    session_close(&session);
+    close(server_socket_fd);
+    report_game_over(&session, outcome, "Player 2");
+    stop_ai();
+}
 
-        //check if we won
-        bool won = true;
-        for(int i = 0; i<NDIFSHIPS; i++){
-            if(!enemyFleetStatus[i]) won = false;
-        }
-        if(won){
-            sleep(1);
-            werase(prompt_win);
-            box(prompt_win, 0, 0);
-            cursor = 1;
-            mvwprintw(prompt_win, cursor++, 1, "Congratulations, you win!");
-            free(most_recent_prompt);
-            most_recent_prompt = strdup("Congratulations, you win!");
-            game_running = false;
-            mvwprintw(prompt_win, cursor++, 1, "Exiting...");
-            free(most_recent_prompt);
-            most_recent_prompt = strdup("Exiting...");
-            wrefresh(prompt_win);
-            sleep(5);
-            continue;
-        }
 
-        //update our opponent board
-        draw_opponent_board(opponent_win, player1_board.array);
-        wrefresh(prompt_win);
+/**
+ * Initializes the client-side logic for the game. Against a "./battleship server" the client is
+ * always Player 2. Against a match host ("./battleship host") the host tells us which seat we got
+ * in its READY message: seat 0 means we are Player 1 and shoot first. A host seating more than two
+ * players per match says so in the same message, and we play everybody against everybody.
+ *
+ * @param server_name The IP or hostname of the server
+ * @param port        The port number the server is listening on.
+ * @param script_path Script to play from instead of the keyboard ("-" for stdin), or NULL
+ * @param fast_mode   true to skip the pauses between screens (always on with a script)
+ */
+void run_client(char* server_name, unsigned short port, const char* script_path, bool fast_mode) {
+    fast = fast_mode;
+    script_t script_storage;
+    open_script(script_path, &script_storage);
+
+    // Connect to the server
+    int socket_fd = socket_connect(server_name, port);
+    if (socket_fd == -1) {
+        perror("Failed to connect to server");
+        exit(EXIT_FAILURE);
+    }
+    printf("Connected to server!\n");
+
+    // Turns are tiny messages, so don't let Nagle hold them back
+    int opt = 1;
+    setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    session_t session;
+    session_init(&session, socket_fd, 1);
+    pause_for_player(1);
+
+    WINDOW *player_win, *opponent_win, *prompt_win;
+    start_screen(&player_win, &opponent_win, &prompt_win);
+
+    // Initialize and place our board, and our view of the opponent's board
+    board_t my_board, their_board;
+    if (!place_fleet(&my_board, &their_board, "p2Board.txt", player_win, opponent_win, prompt_win)) {
+        session_close(&session);
+        end_screen();
+        exit(EXIT_FAILURE);
     }
 
-    // Stop the tracking threads
+    // Notify the server that the client is ready, then wait for the opponent to finish placing
+    // ships. The READY that starts the match tells us our seat.
+    render_print(prompt_win, cursor++, 1, "Waiting for opponent to place ships...");
+    if (session_ready(&session, 0) == -1 || session_wait_start(&session, true) == -1) {
+        session_close(&session);
+        end_screen();
+        printf("Exiting with exit failure because server was NOT ready\n.");
+        exit(EXIT_FAILURE);
+    }
+    bool attack_first = session.seat == 0;
+    const char* opponent_name = attack_first ? "Player 2" : "Player 1";
+    if (session.players > 2) {
+        // Everybody against everybody: there's no single opponent, so nobody's fleet is tracked
+        opponent_name = "the last player standing";
+        render_print(prompt_win, cursor++, 1, "All %d players are ready! You are Player %d.", session.players,
+                     session.seat + 1);
+        pause_for_player(1);
+        start_victory_tracking(&my_board, NULL);
+        play_ffa(&session, &my_board, player_win, opponent_win, prompt_win);
+    } else {
+        render_print(prompt_win, cursor++, 1, "Opponent is ready! Starting game...");
+        pause_for_player(1);
+
+        // Start victory tracking
+        start_victory_tracking(&my_board, &their_board);
+        play_game(&session, opponent_name, &my_board, &their_board, player_win, opponent_win, prompt_win);
+    }
+
+    // The turn loop only ends once there's a winner or the game can't go on, so stop tracking
+    // (which releases the wait if nobody won) and report the result
     stop_victory_tracking();
+    victory_t outcome = wait_for_victory();
+    show_game_over(prompt_win, outcome, opponent_name);
     stop_cursor_tracking();
 
-    // Close the connection and end curses
+    // End curses and close the connection
+    end_screen();
+    session_close(&session);
+    report_game_over(&session, outcome, opponent_name);
+}
+
+
+/**
+ * Watches a match host's featured matches as a spectator, printing a line for every shot and for
+ * every player who leaves, until the host hangs up
+ *
+ * @param server_name The IP or hostname of the match host
+ * @param port        The port number the host is listening on
+ */
+void run_spectator(char* server_name, unsigned short port) {
+    int socket_fd = socket_connect(server_name, port);
+    if (socket_fd == -1) {
+        perror("Failed to connect to host");
+        exit(EXIT_FAILURE);
+    }
+    frame_t watch = {.type = MSG_WATCH, .ship = NO_SHIP};
+    if (send_frame(socket_fd, &watch) == -1) {
+        perror("Failed to ask to watch");
+        exit(EXIT_FAILURE);
+    }
+    printf("Waiting for a match to watch...\n");
+    fflush(stdout);
+
+    msg_conn_t conn;
+    msg_conn_init(&conn, socket_fd);
+    int players = 0, left = 0;
+    int sunk[MAX_SEATS];
+    bool out[MAX_SEATS];
+    frame_t frame;
+    while (receive_frame(&conn, &frame) == 0) {
+        if (frame.type == MSG_WATCH) {
+            // A new featured match: everybody has a whole fleet again
+            players = left = frame.target != 0 ? frame.target : 2;
+            for (int seat = 0; seat < players; seat++) {
+                sunk[seat] = 0;
+                out[seat] = false;
+            }
+            printf("\nWatching a %d-player match.\n", players);
+        } else if (players == 0 || frame.seat >= players || frame.target >= players) {
+            continue;
+        } else if (frame.type == MSG_QUIT && !out[frame.seat]) {
+            out[frame.seat] = true;
+            left--;
+            printf("Player %d left the match.\n", frame.seat + 1);
+        } else if (frame.type == MSG_RESULT) {
+            char col = frame.x + 'A' - 1;
+            if (frame.outcome == RESULT_SUNK) {
+                printf("Player %d sunk Player %d's %s at %c,%d!\n", frame.seat + 1, frame.target + 1,
+                       shipArray[frame.ship].name, col, frame.y);
+                if (++sunk[frame.target] == NDIFSHIPS && !out[frame.target]) {
+                    out[frame.target] = true;
+                    left--;
+                    printf("Player %d's fleet is gone!\n", frame.target + 1);
+                }
+            } else {
+                printf("Player %d %s Player %d at %c,%d.\n", frame.seat + 1,
+                       frame.outcome == RESULT_HIT ? "hit" : "missed", frame.target + 1, col, frame.y);
+            }
+        }
+
+        if (players > 0 && left == 1) {
+            for (int seat = 0; seat < players; seat++) {
+                if (!out[seat]) printf("Player %d wins!\n", seat + 1);
+            }
+            left = 0;
+        }
+        fflush(stdout);
+    }
+    printf("The host closed the connection.\n");
     close(socket_fd);
-    end_curses();
 }
 
 
@@ -583,39 +1108,55 @@ void run_client(char* server_name, unsigned short port) {
  * @param prompt_win The curses window for displaying prompt
  */
 void welcome_message(WINDOW* prompt_win) {
-    wclear(prompt_win);     // Clear the prompt window
-    box(prompt_win, 0, 0);  // Redraw the border
-    mvwprintw(prompt_win, 1, 1, "============================================================");
-    mvwprintw(prompt_win, 2, 1, "                WELCOME TO BATTLESHIP!");
-    mvwprintw(prompt_win, 3, 1, "============================================================");
-    mvwprintw(prompt_win, 5, 1, "Rules of the game:");
-    mvwprintw(prompt_win, 6, 1, "1. Each player has a 10x10 grid to place 5 ships:");
-    mvwprintw(prompt_win, 7, 1, "   - Destroyer (2 spaces)");
-    mvwprintw(prompt_win, 8, 1, "   - Submarine (3 spaces)");
-    mvwprintw(prompt_win, 9, 1, "   - Cruiser (3 spaces)");
-    mvwprintw(prompt_win, 10, 1, "   - Battleship (4 spaces)");
-    mvwprintw(prompt_win, 11, 1, "   - Aircraft Carrier (5 spaces)");
-    mvwprintw(prompt_win, 13, 1, "2. Players take turns guessing coordinates to attack.");
-    mvwprintw(prompt_win, 14, 1, "3. A hit will mark part of a ship as damaged.");
-    mvwprintw(prompt_win, 15, 1, "   NOTE: Players do not get consecutive turns if they hit an enemy ship");
-    mvwprintw(prompt_win, 16, 1, "4. A ship is sunk when all its parts are hit.");
-    mvwprintw(prompt_win, 17, 1, "5. The game ends when all ships of one player are sunk.");
-    mvwprintw(prompt_win, 19, 1, "============================================================");
-    mvwprintw(prompt_win, 20, 1, "                 LET THE BATTLE BEGIN!");
-    mvwprintw(prompt_win, 21, 1, "============================================================");
-    mvwprintw(prompt_win, 23, 1, "Press Enter to start the game...");
-    wrefresh(prompt_win);       // Refresh the window to display changes
+    render_erase(prompt_win);   // Clear the prompt window
+    render_box(prompt_win);     // Redraw the border
+    render_print(prompt_win, 1, 1, "============================================================");
+    render_print(prompt_win, 2, 1, "                WELCOME TO BATTLESHIP!");
+    render_print(prompt_win, 3, 1, "============================================================");
+    render_print(prompt_win, 5, 1, "Rules of the game:");
+    render_print(prompt_win, 6, 1, "1. Each player has a %dx%d grid to place %d ships:", NCOLS, NROWS, NDIFSHIPS);
+    int line = 7;
+    for (int i = 0; i < NDIFSHIPS; i++) {
+        render_print(prompt_win, line++, 1, "   - %s (%d spaces)", shipArray[i].name, shipArray[i].size);
+    }
+    line++;
+    render_print(prompt_win, line++, 1, "2. Players take turns guessing coordinates to attack.");
+    render_print(prompt_win, line++, 1, "3. A hit will mark part of a ship as damaged.");
+    render_print(prompt_win, line++, 1, "   NOTE: Players do not get consecutive turns if they hit an enemy ship");
+    render_print(prompt_win, line++, 1, "4. A ship is sunk when all its parts are hit.");
+    render_print(prompt_win, line++, 1, "5. The game ends when all ships of one player are sunk.");
+    line++;
+    render_print(prompt_win, line++, 1, "============================================================");
+    render_print(prompt_win, line++, 1, "                 LET THE BATTLE BEGIN!");
+    render_print(prompt_win, line++, 1, "============================================================");
+    line++;
+    render_print(prompt_win, line, 1, "Press Enter to start the game...");
     
     // Wait for the player to press Enter
     int ch;
     do {
-        ch = wgetch(prompt_win);
+        ch = prompt_getch();
     } while (ch != '\n');
 
     // Clear the prompt window after Enter is pressed
-    wclear(prompt_win);
-    box(prompt_win, 0, 0);  // Redraw the border for further prompts
-    wrefresh(prompt_win);
+    render_erase(prompt_win);
+    render_box(prompt_win);  // Redraw the border for further prompts
+}
+
+
+/**
+ * Read a line of keys (without the newline) into buffer
+ *
+ * @param buffer   Where to store the line
+ * @param capacity Size of buffer, including the null terminator
+ */
+static void read_line(char* buffer, size_t capacity) {
+    size_t len = 0;
+    int ch;
+    while ((ch = prompt_getch()) != '\n') {
+        if (len + 1 < capacity) buffer[len++] = ch;
+    }
+    buffer[len] = '\0';
 }
 
 
@@ -625,13 +1166,13 @@ void welcome_message(WINDOW* prompt_win) {
  * 
  * @param prompt_win    The curses window for displaying prompts
  * @param input         The user input being read.
- * @param leave_player  The player that is trying to exit
+ * @param seat          Seat of the player that is trying to exit
  * @param oppo_player   The player thats just chillin
  * @param socket_fd     Socket sending the quit message
  */
-void player_leave(WINDOW* prompt_win, char* input, const char* leave_player, const char* oppo_player, int socket_fd) {
+void player_leave(WINDOW* prompt_win, char* input, int seat, const char* oppo_player, int socket_fd) {
     // Read input from the user in the prompt window
-    wgetnstr(prompt_win, input, 256); // 256 is just the buffer size
+    read_line(input, 256); // 256 is just the buffer size
 
     // Trim newline char if present
     size_t len = strlen(input);
@@ -642,48 +1183,40 @@ void player_leave(WINDOW* prompt_win, char* input, const char* leave_player, con
     // Check if the input is 'Q'
     if (strcasecmp(input, "Q") == 0) {
         // Ask the user for confirmation
-        wclear(prompt_win);
-        mvwprintw(prompt_win, cursor++, 1, "Only losers rage quit. Are you sure you want to leave the game? (Y/N): ");
-        wrefresh(prompt_win);
+        render_erase(prompt_win);
+        render_print(prompt_win, cursor++, 1, "Only losers rage quit. Are you sure you want to leave the game? (Y/N): ");
 
         char confirm[256];
-        wgetnstr(prompt_win, confirm, 256);
+        read_line(confirm, 256);
 
         // Check confirmation response
         if (strcasecmp(confirm, "Y") == 0) {
             // If confirmed, notify both players and exit
-            char quit_message[256];
-            snprintf(quit_message, sizeof(quit_message), "%s rage quit. You win!", leave_player);
-            send_message(socket_fd, quit_message);      // Notify the opposing player
-
-            wclear(prompt_win);
-            mvwprintw(prompt_win, cursor++, 1, "Oh well...%s Wins!", oppo_player);
-            wrefresh(prompt_win);
-            sleep(2);       // Pause before exiting
+            frame_t quit = {.type = MSG_QUIT, .seat = seat, .ship = NO_SHIP};
+            send_frame(socket_fd, &quit);      // Notify the opposing player
+
+            render_erase(prompt_win);
+            render_print(prompt_win, cursor++, 1, "Oh well...%s Wins!", oppo_player);
+            pause_for_player(2);    // Pause before exiting
             end_curses();   // End the curses environment
             exit(0);        // Exit the program
         } else if (strcasecmp(confirm, "N") == 0) {
             // If not confirmed, clear the prompt and return to the last state of the game
-            wclear(prompt_win);
-            mvwprintw(prompt_win, cursor++, 1, "Returning to the game...");
-            wrefresh(prompt_win);
-            sleep(1);   // Pause for clarity
-            wclear(prompt_win);
-            wrefresh(prompt_win);
+            render_erase(prompt_win);
+            render_print(prompt_win, cursor++, 1, "Returning to the game...");
+            pause_for_player(1);    // Pause for clarity
+            render_erase(prompt_win);
             return;        
         } else {
             // Handle input during confirmation
-            wclear(prompt_win);
-            mvwprintw(prompt_win, cursor++, 1, "Invalid response. Returning to the game...");
-            wrefresh(prompt_win);
-            sleep(1);   // Pause for clarity
-            wclear(prompt_win);
-            wrefresh(prompt_win);
+            render_erase(prompt_win);
+            render_print(prompt_win, cursor++, 1, "Invalid response. Returning to the game...");
+            pause_for_player(1);    // Pause for clarity
+            render_erase(prompt_win);
             return;
         }
     } 
 
     // Clear the prompt window after receiving valid input
-    wclear(prompt_win);
-    wrefresh(prompt_win);
+    render_erase(prompt_win);
 }
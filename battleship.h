@@ -1,30 +1,58 @@
 #pragma once
 
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <netinet/tcp.h>
 
 #include "board.h"
+#include "prompt.h"
+#include "script.h"
+#include "ai.h"
+#include "montecarlo.h"
+#include "placement.h"
+#include "session.h"
 #include "gameMessage.h"
+#include "protocol.h"
 #include "socket.h"
 #include "graphics.h"
+#include "render.h"
+#include "matchServer.h"
 
 /**
  * Initializes the server-side (Player 1) logic for the game 
  * 
- * @param port The port number the server will listen on
+ * @param port        The port number the server will listen on
+ * @param script_path Script to play from instead of the keyboard ("-" for stdin), or NULL
+ * @param fast_mode   true to skip the pauses between screens (always on with a script)
+ * @param computer    true to have the computer (see ai.h) play Player 1 instead of a person
+ * @param mc_budget_ms With computer, Monte Carlo sampling time per attack (see montecarlo.h), or 0
+ *                     for the heatmap AI
  */ 
-void run_server(unsigned short port);
+void run_server(unsigned short port, const char* script_path, bool fast_mode, bool computer, unsigned mc_budget_ms);
 
 /**
  * Initializes the client-side (Player 2) logic for the game
  * 
  * @param server_name The IP or hostname of the server
  * @param port        The port number the server is listening on.
+ * @param script_path Script to play from instead of the keyboard ("-" for stdin), or NULL
+ * @param fast_mode   true to skip the pauses between screens (always on with a script)
  */
-void run_client(char *server_name, unsigned short port);
+void run_client(char *server_name, unsigned short port, const char* script_path, bool fast_mode);
+
+/**
+ * Watches the featured matches of a match host ("./battleship host") as a spectator, printing
+ * every shot as it happens, until the host hangs up
+ *
+ * @param server_name The IP or hostname of the match host
+ * @param port        The port number the host is listening on
+ */
+void run_spectator(char* server_name, unsigned short port);
 
 /**
  * Display a welcome message to the players when they connect to the server.
@@ -39,8 +67,8 @@ void welcome_message(WINDOW* prompt_win);
  * 
  * @param prompt_win    The curses window for displaying prompts
  * @param input         The user input being read.
- * @param leave_player  The player that is trying to exit
+ * @param seat          Seat of the player that is trying to exit
  * @param oppo_player   The player thats just chillin
  * @param socket_fd     Socket sending the quit message
  */
-void player_leave(WINDOW* prompt_win, char* input, const char* leave_player, const char* oppo_player, int socket_fd);
\ No newline at end of file
+void player_leave(WINDOW* prompt_win, char* input, int seat, const char* oppo_player, int socket_fd);
\ No newline at end of file
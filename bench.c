@@ -0,0 +1,327 @@
+/**
+ * Microbenchmarks for the board engine. Each benchmark runs one engine operation over randomized
+ * boards and inputs, doubling the number of operations until a run takes at least the minimum
+ * time, and reports nanoseconds per operation as JSON on stdout so runs can be compared.
+ *
+ * Usage: battleship-bench [min-seconds-per-benchmark]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ai.h"
+#include "board.h"
+#include "placement.h"
+#include "sparse.h"
+
+#define POOL_SIZE 1024  // distinct random boards and inputs each benchmark cycles through (power of two)
+#define MASSIVE_SIDE 100000     // rows and columns of the massive sparse board
+#define MASSIVE_SHIPS 500       // ships on it, sizes 2 to 6
+#define MASSIVE_GAME 1000000    // guesses before the massive board starts a rematch
+
+//randomized inputs shared by the benchmarks
+static board_t fleets[POOL_SIZE];           // fully placed boards, nothing guessed
+static board_t midgame[POOL_SIZE];          // placed boards with about half the cells guessed
+static shipLocation_t proposals[POOL_SIZE]; // random placements, some off the board
+static uint8_t guess_order[POOL_SIZE][BB_CELLS];
+static ai_t ai_states[POOL_SIZE];           // AIs part way through a game against fleets[i]
+static sparse_board_t massive;              // a massive board with a random fleet, nothing guessed
+static uint32_t massive_sizes[MASSIVE_SHIPS];
+
+//everything a benchmark computes ends up here, so the compiler can't drop the work
+static volatile uint64_t sink;
+
+/**
+ * benchmark struct, stores one benchmark: its name and a function that runs n operations
+ */
+typedef struct benchmark {
+    const char* name;
+    uint64_t (*run)(uint64_t n);
+} benchmark_t;
+
+/**
+ * Read the monotonic clock
+ *
+ * @return The time in nanoseconds
+ */
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Make a random placement proposal (anywhere, so some cross the edge of the board)
+ */
+static shipLocation_t random_proposal(unsigned* seed) {
+    shipLocation_t proposal = {.shipType = shipArray[rand_r(seed) % NDIFSHIPS], .sunk = false};
+    proposal.orientation = rand_r(seed) % 2 ? VERTICAL : HORIZONTAL;
+    proposal.startx = rand_r(seed) % NCOLS + 1;
+    proposal.starty = rand_r(seed) % NROWS + 1;
+    return proposal;
+}
+
+/**
+ * Place a random fleet the way makeBoard does: propose each ship in turn and keep it once it
+ * passes checkBounds and checkOverlap
+ *
+ * @param board The board (reset first)
+ * @param seed  Random state
+ */
+static void random_fleet(board_t* board, unsigned* seed) {
+    initBoard(board);
+    for (int i = 0; i < NDIFSHIPS; i++) {
+        shipLocation_t proposal = {.shipType = shipArray[i], .sunk = false};
+        do {
+            proposal.orientation = rand_r(seed) % 2 ? VERTICAL : HORIZONTAL;
+            proposal.startx = rand_r(seed) % NCOLS + 1;
+            proposal.starty = rand_r(seed) % NROWS + 1;
+        } while (!checkBounds(proposal) || checkOverlap(board, proposal));
+        placeShip(board, i, proposal);
+    }
+}
+
+/**
+ * Fill the input pools
+ */
+static void make_inputs() {
+    unsigned seed = 1;
+    for (int i = 0; i < POOL_SIZE; i++) {
+        random_fleet(&fleets[i], &seed);
+        proposals[i] = random_proposal(&seed);
+
+        // A random order to guess every cell in
+        for (int c = 0; c < BB_CELLS; c++) {
+            int j = rand_r(&seed) % (c + 1);
+            guess_order[i][c] = guess_order[i][j];
+            guess_order[i][j] = c;
+        }
+
+        midgame[i] = fleets[i];
+        for (int c = 0; c < BB_CELLS / 2; c++) {
+            int cell = guess_order[i][c];
+            board_guess(&midgame[i], cell % NCOLS + 1, cell / NCOLS + 1);
+        }
+
+        // Let an AI take up to 40 of its own shots at the fleet (a typical game is about 45)
+        board_t target = fleets[i];
+        ai_init(&ai_states[i], i);
+        int shots = rand_r(&seed) % 40;
+        for (int s = 0; s < shots; s++) {
+            int x, y;
+            ai_choose_shot(&ai_states[i], &x, &y);
+            guess_result_t result = board_guess(&target, x, y);
+            ai_record_shot(&ai_states[i], x, y, result, board_ship_at(&target, x, y));
+        }
+    }
+
+    rng_t rng;
+    rng_seed(&rng, 1);
+    for (int i = 0; i < MASSIVE_SHIPS; i++) massive_sizes[i] = 2 + i % 5;
+    if (sparse_board_init(&massive, MASSIVE_SIDE, MASSIVE_SIDE) == -1 ||
+        sparse_random_fleet(&massive, massive_sizes, MASSIVE_SHIPS, &rng) == -1) {
+        fprintf(stderr, "Failed to set up the massive board\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Pick a cell of the massive board: every other one is on a ship, the rest anywhere (almost always water)
+ */
+static void massive_cell(rng_t* rng, uint32_t* x, uint32_t* y) {
+    if (rng_next(rng) & 1) {
+        *x = rng_below(rng, MASSIVE_SIDE) + 1;
+        *y = rng_below(rng, MASSIVE_SIDE) + 1;
+        return;
+    }
+    const sparse_ship_t* ship = &massive.ships[rng_below(rng, massive.shipCount)];
+    uint32_t k = rng_below(rng, ship->size);
+    *x = ship->startx + (ship->orientation == HORIZONTAL ? k : 0);
+    *y = ship->starty + (ship->orientation == VERTICAL ? k : 0);
+}
+
+static uint64_t bench_init_board(uint64_t n) {
+    board_t board;
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        initBoard(&board);
+        sum += board.occupied.w[i % BB_WORDS];
+    }
+    return sum;
+}
+
+static uint64_t bench_check_bounds(uint64_t n) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        sum += checkBounds(proposals[i & (POOL_SIZE - 1)]);
+    }
+    return sum;
+}
+
+static uint64_t bench_check_overlap(uint64_t n) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        // Only in-bounds proposals are valid input
+        shipLocation_t proposal = proposals[i & (POOL_SIZE - 1)];
+        if (proposal.orientation == HORIZONTAL && proposal.startx + proposal.shipType.size - 1 > NCOLS) {
+            proposal.startx = NCOLS - proposal.shipType.size + 1;
+        }
+        if (proposal.orientation == VERTICAL && proposal.starty + proposal.shipType.size - 1 > NROWS) {
+            proposal.starty = NROWS - proposal.shipType.size + 1;
+        }
+        sum += checkOverlap(&fleets[(i >> 10) & (POOL_SIZE - 1)], proposal);
+    }
+    return sum;
+}
+
+// One operation is one guess; a fresh copy of a board takes every cell in a random order
+static uint64_t bench_board_guess(uint64_t n) {
+    board_t board;
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        int turn = i % BB_CELLS;
+        int game = (i / BB_CELLS) & (POOL_SIZE - 1);
+        if (turn == 0) board = fleets[game];
+        int cell = guess_order[game][turn];
+        sum += board_guess(&board, cell % NCOLS + 1, cell / NCOLS + 1);
+    }
+    return sum;
+}
+
+static uint64_t bench_check_victory(uint64_t n) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        sum += checkVictory(&midgame[i & (POOL_SIZE - 1)]);
+    }
+    return sum;
+}
+
+// One operation is a whole fleet, placed with the same checks makeBoard runs on each proposal
+static uint64_t bench_random_fleet(uint64_t n) {
+    board_t board;
+    unsigned seed = 7;
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        random_fleet(&board, &seed);
+        sum += board.occupied.w[i % BB_WORDS];
+    }
+    return sum;
+}
+
+// One operation is a whole fleet, placed from the precomputed placement masks
+static uint64_t bench_board_random_fleet(uint64_t n) {
+    board_t board;
+    rng_t rng;
+    rng_seed(&rng, 7);
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        board_random_fleet(&board, &rng);
+        sum += board.occupied.w[i % BB_WORDS];
+    }
+    return sum;
+}
+
+// One operation is one shot decision of the AI, somewhere in the first 40 shots of a game
+static uint64_t bench_ai_choose_shot(uint64_t n) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        int x, y;
+        ai_choose_shot(&ai_states[i & (POOL_SIZE - 1)], &x, &y);
+        sum += x + y;
+    }
+    return sum;
+}
+
+// One operation is finding the ship on a cell of the massive board
+static uint64_t bench_sparse_ship_at(uint64_t n) {
+    rng_t rng;
+    rng_seed(&rng, 3);
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        uint32_t x, y;
+        massive_cell(&rng, &x, &y);
+        sum += sparse_ship_at(&massive, x, y);
+    }
+    return sum;
+}
+
+// One operation is one guess at the massive board, which starts a rematch every MASSIVE_GAME guesses
+static uint64_t bench_sparse_guess(uint64_t n) {
+    rng_t rng;
+    rng_seed(&rng, 5);
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        if (i % MASSIVE_GAME == 0) sparse_clear_guesses(&massive);
+        uint32_t x, y;
+        massive_cell(&rng, &x, &y);
+        sum += sparse_guess(&massive, x, y, NULL);
+    }
+    sum += sparse_victory(&massive);
+    return sum;
+}
+
+// One operation is placing all MASSIVE_SHIPS ships at random on an empty massive board
+static uint64_t bench_sparse_random_fleet(uint64_t n) {
+    sparse_board_t board;
+    rng_t rng;
+    rng_seed(&rng, 7);
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        sparse_board_init(&board, MASSIVE_SIDE, MASSIVE_SIDE);
+        sum += sparse_random_fleet(&board, massive_sizes, MASSIVE_SHIPS, &rng);
+        sparse_board_free(&board);
+    }
+    return sum;
+}
+
+static const benchmark_t benchmarks[] = {
+    {"initBoard", bench_init_board},
+    {"checkBounds", bench_check_bounds},
+    {"checkOverlap", bench_check_overlap},
+    {"board_guess", bench_board_guess},
+    {"checkVictory", bench_check_victory},
+    {"random_fleet_makeBoard_checks", bench_random_fleet},
+    {"board_random_fleet", bench_board_random_fleet},
+    {"ai_choose_shot", bench_ai_choose_shot},
+    {"sparse_ship_at", bench_sparse_ship_at},
+    {"sparse_guess", bench_sparse_guess},
+    {"sparse_random_fleet", bench_sparse_random_fleet},
+};
+
+int main(int argc, char* argv[]) {
+    double min_seconds = argc > 1 ? atof(argv[1]) : 0.2;
+    if (min_seconds <= 0) {
+        fprintf(stderr, "Usage: %s [min-seconds-per-benchmark]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    uint64_t min_ns = min_seconds * 1e9;
+
+    make_inputs();
+
+    printf("{\n");
+    printf("  \"rows\": %d, \"cols\": %d, \"ships\": %d, \"board_bytes\": %zu,\n", NROWS, NCOLS, NDIFSHIPS,
+           sizeof(board_t));
+    printf("  \"massive_side\": %d, \"massive_ships\": %d, \"massive_fleet_bytes\": %zu,\n", MASSIVE_SIDE,
+           MASSIVE_SHIPS, sparse_board_bytes(&massive));
+    printf("  \"benchmarks\": [\n");
+    size_t count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+    for (size_t b = 0; b < count; b++) {
+        // Double the operation count until one run is long enough to time reliably
+        uint64_t n = 1024;
+        uint64_t elapsed;
+        while (true) {
+            uint64_t start = now_ns();
+            sink += benchmarks[b].run(n);
+            elapsed = now_ns() - start;
+            if (elapsed >= min_ns) break;
+            n *= 2;
+        }
+        printf("    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"ops\": %llu}%s\n", benchmarks[b].name,
+               (double)elapsed / n, (unsigned long long)n, b + 1 < count ? "," : "");
+    }
+    printf("  ]\n}\n");
+    return 0;
+}
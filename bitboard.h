@@ -0,0 +1,196 @@
+/**
+ * Bitboards - one bit per cell of the game board.
+ *
+ * Cell (x, y) (1-indexed, x is the column) is bit (y-1)*NCOLS + (x-1), so a horizontal ship is a run
+ * of adjacent bits and a vertical ship is every NCOLS-th bit. A 10x10 board fits in two 64-bit words,
+ * the largest one (16x16) in four.
+ * Every operation is a short loop over BB_WORDS words, which the compiler unrolls into a couple of
+ * (vector) instructions.
+ *
+ * Included by board.h, which gets NROWS and NCOLS from the ruleset (rules.h).
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BB_CELLS (NROWS * NCOLS)        // bits in use
+#define BB_WORDS ((BB_CELLS + 63) / 64) // 64-bit words per bitboard
+
+/**
+ * bitboard struct, stores one bit per board cell
+ */
+typedef struct bitboard {
+    uint64_t w[BB_WORDS];
+} bitboard_t;
+
+/**
+ * Get the bit index of a cell
+ *
+ * @param x Column, 1..NCOLS
+ * @param y Row, 1..NROWS
+ * @return The bit index
+ */
+static inline int bb_index(int x, int y) {
+    return (y - 1) * NCOLS + (x - 1);
+}
+
+/**
+ * Check if a cell's bit is set
+ *
+ * @param bb The bitboard
+ * @param x  Column, 1..NCOLS
+ * @param y  Row, 1..NROWS
+ * @return true if set
+ */
+static inline bool bb_test(const bitboard_t* bb, int x, int y) {
+    int i = bb_index(x, y);
+    return (bb->w[i / 64] >> (i % 64)) & 1;
+}
+
+/**
+ * Set a cell's bit
+ *
+ * @param bb The bitboard
+ * @param x  Column, 1..NCOLS
+ * @param y  Row, 1..NROWS
+ */
+static inline void bb_set(bitboard_t* bb, int x, int y) {
+    int i = bb_index(x, y);
+    bb->w[i / 64] |= (uint64_t)1 << (i % 64);
+}
+
+/**
+ * Bitwise a & b
+ */
+static inline bitboard_t bb_and(bitboard_t a, bitboard_t b) {
+    bitboard_t r;
+    for (int i = 0; i < BB_WORDS; i++) r.w[i] = a.w[i] & b.w[i];
+    return r;
+}
+
+/**
+ * Bitwise a & ~b (the cells of a that aren't in b)
+ */
+static inline bitboard_t bb_andnot(bitboard_t a, bitboard_t b) {
+    bitboard_t r;
+    for (int i = 0; i < BB_WORDS; i++) r.w[i] = a.w[i] & ~b.w[i];
+    return r;
+}
+
+/**
+ * Bitwise a | b
+ */
+static inline bitboard_t bb_or(bitboard_t a, bitboard_t b) {
+    bitboard_t r;
+    for (int i = 0; i < BB_WORDS; i++) r.w[i] = a.w[i] | b.w[i];
+    return r;
+}
+
+/**
+ * Bitwise a ^ b
+ */
+static inline bitboard_t bb_xor(bitboard_t a, bitboard_t b) {
+    bitboard_t r;
+    for (int i = 0; i < BB_WORDS; i++) r.w[i] = a.w[i] ^ b.w[i];
+    return r;
+}
+
+/**
+ * Move every bit n places up (bit i becomes bit i + n). Bits moved past the last word are dropped;
+ * bits moved past BB_CELLS stay set in the last word, so mask the result if it matters.
+ */
+static inline bitboard_t bb_shl(bitboard_t a, int n) {
+    bitboard_t r;
+    int words = n / 64, bits = n % 64;
+    for (int i = BB_WORDS - 1; i >= 0; i--) {
+        int from = i - words;
+        r.w[i] = from >= 0 ? a.w[from] << bits : 0;
+        if (from > 0 && bits != 0) r.w[i] |= a.w[from - 1] >> (64 - bits);
+    }
+    return r;
+}
+
+/**
+ * Move every bit n places down (bit i becomes bit i - n)
+ */
+static inline bitboard_t bb_shr(bitboard_t a, int n) {
+    bitboard_t r;
+    int words = n / 64, bits = n % 64;
+    for (int i = 0; i < BB_WORDS; i++) {
+        int from = i + words;
+        r.w[i] = from < BB_WORDS ? a.w[from] >> bits : 0;
+        if (from + 1 < BB_WORDS && bits != 0) r.w[i] |= a.w[from + 1] << (64 - bits);
+    }
+    return r;
+}
+
+/**
+ * Get the mask of every cell on the board
+ */
+static inline bitboard_t bb_all() {
+    bitboard_t r;
+    for (int i = 0; i < BB_WORDS; i++) {
+        int bits = BB_CELLS - i * 64;
+        r.w[i] = bits >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << bits) - 1;
+    }
+    return r;
+}
+
+/**
+ * Find the k-th set bit (counting from 0, lowest bit first)
+ *
+ * @param a The bitboard
+ * @param k Which set bit, less than bb_count(a)
+ * @return Its bit index
+ */
+static inline int bb_select(bitboard_t a, int k) {
+    for (int i = 0; i < BB_WORDS; i++) {
+        int n = __builtin_popcountll(a.w[i]);
+        if (k < n) {
+            uint64_t w = a.w[i];
+            while (k-- > 0) w &= w - 1;
+            return i * 64 + __builtin_ctzll(w);
+        }
+        k -= n;
+    }
+    return -1;
+}
+
+/**
+ * Check if no bit is set
+ */
+static inline bool bb_empty(bitboard_t a) {
+    uint64_t any = 0;
+    for (int i = 0; i < BB_WORDS; i++) any |= a.w[i];
+    return any == 0;
+}
+
+/**
+ * Count the set bits
+ */
+static inline int bb_count(bitboard_t a) {
+    int n = 0;
+    for (int i = 0; i < BB_WORDS; i++) n += __builtin_popcountll(a.w[i]);
+    return n;
+}
+
+/**
+ * Build the mask of a straight line of cells, the shape of a placed ship
+ *
+ * @param x        Column of the first cell
+ * @param y        Row of the first cell
+ * @param size     Number of cells
+ * @param vertical true to run down the column, false to run along the row
+ * @return The mask (cells off the board are not included)
+ */
+static inline bitboard_t bb_line(int x, int y, int size, bool vertical) {
+    bitboard_t r = {{0}};
+    for (int i = 0; i < size; i++) {
+        int cx = vertical ? x : x + i;
+        int cy = vertical ? y + i : y;
+        if (cx >= 1 && cx <= NCOLS && cy >= 1 && cy <= NROWS) bb_set(&r, cx, cy);
+    }
+    return r;
+}
@@ -1,12 +1,20 @@
+/**
+ * The game engine: boards, ship placement, guesses, and victory. Nothing here touches curses,
+ * so this header and board.c (with cell.c, protocol.c, and gameMessage.c) make up
+ * libbattleship, which bots, servers, and tests can link without a terminal. The interactive
+ * prompts are declared in prompt.h.
+ */
+
 #pragma once
 #include <stdbool.h>
-#include <curses.h>
 #include <stddef.h>
+#include <stdint.h>
 
-#define NROWS 10 //rows for game board
-#define NCOLS 10 //columns for game board
-#define NDIFSHIPS 5 //the number of different types of ships
-#define INIT_CURSOR 1 //vertical start index for the cursor of the user input window
+#include "rules.h"
+
+#define NO_SHIP_INDEX -1 //ship index of a cell without a ship
+
+#include "bitboard.h"
 
 /*
 * shipType struct, stores details about a specific ship, including name, size, and sunk status.
@@ -17,37 +25,118 @@ typedef struct shipType {
   bool sunk;
 } shipType_t;
 
-//  Each player gets 5 ships, a destroyer of size 2, a submarine of size 3, a cruiser of size 3, 
-//  a battleship of size 4, and an aircraft carrier of size 5.
+//  Each player gets the NDIFSHIPS ships of the ruleset's fleet (see rules.h), placed in this order. With the classic
+//  rules that's a destroyer of size 2, a submarine of size 3, a cruiser of size 3, a battleship of size 4, and an
+//  aircraft carrier of size 5.
 extern const shipType_t shipArray[];
 
-// Declare cursor as an external variable to prevent multiple definition errors
-extern size_t cursor;
-extern char * most_recent_prompt;
-extern int space;
-
 /*
-* cell struct, stores details about a specific cell on the game board, including occupied status, guessed status, hit status, and the ship occupying the cell.
+* cell, one byte describing a specific cell on the game board: occupied, guessed, and hit flags, whether the ship on it has sunk,
+* and that ship's index in the board's fleet table. Boards don't store cells; board_cell packs one from the board's bitboards and
+* fleet table for code that wants a per-cell view, so a cell never holds its own copy of a ship and can't disagree with the board.
 */
-typedef struct cell{
-    bool occupied;
-    bool guessed;
-    bool hit;
-    shipType_t ship;
-} cell_t;
+typedef uint8_t cell_t;
+
+#define CELL_SHIP 0x0F      //low bits: fleet index of the ship on the cell, or CELL_NO_SHIP
+#define CELL_NO_SHIP 0x0F
+#define CELL_OCCUPIED 0x10
+#define CELL_GUESSED 0x20
+#define CELL_HIT 0x40
+#define CELL_SUNK 0x80      //the ship on the cell has sunk
+
+_Static_assert(NDIFSHIPS < CELL_NO_SHIP, "a cell's ship index has to fit in its low bits");
 
 /*
 * Returns a boolean, takes in a cell c and determines if c is a currently occupied cell.
 */
 bool isOccupied(cell_t c);
 
+/*
+* Returns a boolean, takes in a cell c and determines if c has already been guessed.
+*/
+bool isGuessed(cell_t c);
+
+/*
+* Returns a boolean, takes in a cell c and determines if c has been hit.
+*/
+bool hasBeenHit(cell_t c);
+
+/*
+* Returns the fleet index of the ship on cell c, or NO_SHIP_INDEX if the cell is empty.
+*/
+int cellShip(cell_t c);
+
 /**
- * board struct, stores an 2d array of cells of size 11*11
+ * fleetShip struct, stores one ship of a board's fleet: where it was placed, how many of its cells
+ * haven't been hit yet, and whether it has sunk. This is the only place a ship's sunk state lives.
+ */
+typedef struct fleetShip{
+    bitboard_t cells;   //cells the ship covers (empty until placed)
+    uint8_t index;      //index of the ship in shipArray
+    uint8_t hitPoints;  //cells of the ship not hit yet
+    bool sunk;
+}fleetShip_t;
+
+//how a game ended
+typedef enum victory {
+  VICTORY_NONE,   //no winner (yet, or the game stopped early)
+  VICTORY_WON,    //the opponent's fleet was destroyed
+  VICTORY_LOST    //our fleet was destroyed
+} victory_t;
+
+/**
+ * board struct, stores the board as bitboards (which cells hold a ship, have been guessed, and
+ * have been hit) plus the fleet table, whose masks say which ship is on each cell. That's three
+ * bits per cell and 176 bytes per board on the classic 10x10 board.
  */
 typedef struct board{
-    cell_t array[NROWS+1][NCOLS+1];
+    bitboard_t occupied;
+    bitboard_t guessed;
+    bitboard_t hit;
+    fleetShip_t fleet[NDIFSHIPS];
+    uint8_t shipsPlaced;
+    uint8_t shipsSunk;
 }board_t;
 
+/**
+ * Get the index in shipArray of the ship on a cell
+ *
+ * @param board The board
+ * @param x     Column, 1..NCOLS
+ * @param y     Row, 1..NROWS
+ * @return The ship index, or NO_SHIP_INDEX if the cell is empty
+ */
+int board_ship_at(const board_t* board, int x, int y);
+
+/**
+ * Pack the per-cell view of a board cell, for drawing and other code that works cell by cell
+ *
+ * @param board The board
+ * @param x     Column, 1..NCOLS
+ * @param y     Row, 1..NROWS
+ * @return The cell
+ */
+cell_t board_cell(const board_t* board, int x, int y);
+
+/**
+ * Mark a cell as guessed, and as hit if hit is true. Used for the opponent's board, where we
+ * only learn results from the network.
+ *
+ * @param board The board
+ * @param x     Column, 1..NCOLS
+ * @param y     Row, 1..NROWS
+ * @param hit   Whether the guess hit a ship
+ */
+void board_mark_guess(board_t* board, int x, int y, bool hit);
+
+/**
+ * Record that one of the ships on the opponent's board sank
+ *
+ * @param board The opponent's board
+ * @param index Index of the ship in shipArray
+ */
+void board_mark_sunk(board_t* board, int index);
+
 //different possible orientations
 enum Orientation {
   HORIZONTAL,
@@ -76,15 +165,29 @@ typedef struct shipLocation{
 bool checkBounds (struct shipLocation proposal);
 
 
-/** updateBoardAfterGuess
- *  Function that updates the board based on the player's guess
- *  Takes a board, coordinates, bools giving information about the
- *  specified cell (to be updated), and the user's input window
+//what a guess did to the board it was made against
+typedef enum guess_result {
+  GUESS_INVALID,    //the coordinates are off the board
+  GUESS_REPEATED,   //the cell was already guessed, so nothing changed
+  GUESS_MISS,
+  GUESS_HIT,
+  GUESS_SUNK        //the hit sank a ship (and possibly ended the game)
+} guess_result_t;
+
+/**
+ * Apply the opponent's guess to a board: mark the cell guessed, and hit if a ship is there.
+ * Signals victory if it sinks the last ship.
+ *
+ * @param board The board being shot at
+ * @param x     Column, 1..NCOLS
+ * @param y     Row, 1..NROWS
+ * @return What the guess did
  */
-void updateBoardAfterGuess(board_t *board, int x, int y, bool *isHit, bool *isSunk, WINDOW * window);
+guess_result_t board_guess(board_t *board, int x, int y);
 
 /**
- * Function to check if all ships on a player's board have been sunk
+ * Function to check if all ships on a player's board have been sunk. Constant time: it only
+ * compares the fleet table's counters.
  * 
  * @param board The player's game board
  * @return true if all ships are sunk, false otherwise.
@@ -94,11 +197,6 @@ bool checkVictory(board_t* board);
 // Function that initializes a players game board
 void initBoard(board_t *board); 
 
-/**printStatus
- *  used by us during debugging to print the occupation status of each cell
- */
-void printStatus(board_t board, WINDOW * window, char* filename);
-
 /**checkOverlap
  *  checkOverlap takes a player's board and proposal shipLocation.
  *  It returns true if there's an overlap present.
@@ -106,51 +204,47 @@ void printStatus(board_t board, WINDOW * window, char* filename);
  */
 bool checkOverlap(board_t * board, struct shipLocation proposal);
 
-/**validOrt
- *  validOrt takes the user input window 
- *  validOrt instructs the user to give us an orientation (either "V" or "H") and loops until 
- *  the user inputs a valid orientation. It then returns that valid orientation.
- *  Since we handle user input here, the function is mostly error checking.
- */
-enum Orientation validOrt(WINDOW * window);
-
-/**validCoords
- *  validCoords takes a pointer to an int array that it will fill with the two valid coordinate
- *  values. It also takes the user input window since it deals with user input. Since this input
- *  is more structured and complicated, most of this function is error checking.
+/**
+ * Place a ship on a board. The proposal must already have passed checkBounds and checkOverlap.
+ *
+ * @param board    The board
+ * @param index    Index of the ship in shipArray
+ * @param proposal Where to put it
  */
-int* validCoords(int * yay, WINDOW * window, char * prompt);
+void placeShip(board_t* board, int index, struct shipLocation proposal);
 
-/**makeBoard
- *  makeBoard takes the input window and the player's board window.
- *  makeBoard loops through all of the ships from the above shipArray and places them on the board based on
- *  user input from the helper functions seen above. It returns the initialized board on success and an empty 
- *  board on failure, but it shouldn't be able to fail.
+/**
+ * Start victory tracking for a game. From then on the guess path (board_guess for our
+ * board, board_mark_sunk for the opponent's) signals the end of the game the moment a fleet is
+ * destroyed; nothing polls.
+ *
+ * @param my_board    This player's board
+ * @param their_board Our view of the opponent's board, or NULL when there are several opponents
+ *                    (see declare_victory)
  */
-board_t makeBoard(WINDOW * window, WINDOW * playerWindow);
-
+void start_victory_tracking(board_t* my_board, board_t* their_board);
 
 /**
- * Start the thread to monitor and reset the prompt window 
- * 
- * @param prompt_win The prompt window to monitor
+ * Record that we won even though no tracked fleet was destroyed: with several opponents there
+ * is no one board to watch, so the game declares the win once every other player is out.
  */
-void start_cursor_tracking(WINDOW* prompt_win);
+void declare_victory();
 
 /**
- * Stop the start_cursor_tracking thread
+ * Check, without waiting, whether either fleet has been destroyed
+ *
+ * @return true once the game has a winner
  */
-void stop_cursor_tracking();
+bool victory_reached();
 
 /**
- * Start the victory tracking thread.
- * 
- * @param player1_board The board of Player 1.
- * @param player2_board The board of Player 2.
+ * Wait until either fleet is destroyed or tracking is stopped
+ *
+ * @return How the game ended
  */
-void start_victory_tracking(board_t* player1_board, board_t* player2_board, WINDOW* prompt_win);
+victory_t wait_for_victory();
 
 /**
- * Stop the victory tracking thread.
+ * Stop victory tracking, waking anything still waiting for a winner.
  */
 void stop_victory_tracking();
@@ -16,17 +16,22 @@
 
 //check if cell is occupied, true if yes false if not
 bool isOccupied(cell_t c){
-    return c.occupied;
+    return c & CELL_OCCUPIED;
 } 
 
 //check if cell has already been guessed, true if yes false if not
 bool isGuessed(cell_t c){
-    return c.guessed;
+    return c & CELL_GUESSED;
 }
 
 //check if cell has been hit, true if yes false if not
 bool hasBeenHit(cell_t c){
-    return c.hit;
+    return c & CELL_HIT;
+}
+
+//get the fleet index of the ship on the cell, NO_SHIP_INDEX if there isn't one
+int cellShip(cell_t c){
+    return (c & CELL_SHIP) == CELL_NO_SHIP ? NO_SHIP_INDEX : (c & CELL_SHIP);
 }
 
 /**
@@ -40,14 +45,14 @@ bool guess(cell_t c){
     //possibly modify this to guard against cell we've already guessed
 
     //update guessed field
-    c.guessed = true;
+    c |= CELL_GUESSED;
 
     //check if cell is occupied
     if(isOccupied(c)){
-        c.hit = HIT;
+        c |= CELL_HIT;
         return HIT;
     } else {
-        c.hit = MISS;
+        c &= ~CELL_HIT;
         return MISS;
     }//ifelse
 }//guess
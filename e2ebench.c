@@ -0,0 +1,275 @@
+/**
+ * End-to-end match benchmark - complete games between two scripted players over loopback TCP.
+ *
+ * Player 1 listens and Player 2 connects, exactly like "./battleship server" and "./battleship
+ * client", and they play with the same frames (send_frame/receive_frame) and the same engine
+ * calls as the interactive game. Fleets and shot orders are random but seeded, so every run plays
+ * the same games. Nothing is drawn and nothing sleeps, so what's measured is the cost of the
+ * protocol, the sockets, and the engine. Matches are played one after another on a fresh
+ * connection each, and the results are printed as JSON:
+ *
+ *   wall time per match   connect to hang-up, as seen by Player 2
+ *   CPU per match         user + system time of both players
+ *   syscalls per turn     socket calls made by both players (reads, writes, and connection setup)
+ *   bytes per turn        bytes both players wrote
+ *
+ * Usage: battleship-e2e [matches]
+ */
+
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "gameMessage.h"
+#include "placement.h"
+#include "protocol.h"
+#include "socket.h"
+
+/**
+ * player struct, stores one side of the benchmark and what it counted
+ */
+typedef struct player {
+    int seat;
+    rng_t rng;
+    int matches;
+    unsigned long turns;        // attacks this player sent
+    unsigned long syscalls;
+    unsigned long bytes;        // bytes this player wrote
+    uint64_t* match_ns;         // Player 2 only: wall time of each match
+} player_t;
+
+//Player 1's listening socket and port
+static int listen_fd;
+static unsigned short port;
+
+/**
+ * Read the monotonic clock
+ *
+ * @return The time in nanoseconds
+ */
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Place a random fleet and shuffle the order we'll shoot in
+ *
+ * @param player The player
+ * @param board  The player's board (reset first)
+ * @param shots  Set to every cell's bit index, in random order
+ */
+static void make_script(player_t* player, board_t* board, uint8_t* shots) {
+    board_random_fleet(board, &player->rng);
+
+    for (int i = 0; i < BB_CELLS; i++) {
+        int j = rng_below(&player->rng, i + 1);
+        shots[i] = shots[j];
+        shots[j] = i;
+    }
+}
+
+/**
+ * Send one frame, counting the write
+ */
+static int player_send(player_t* player, int fd, const frame_t* frame) {
+    player->syscalls++;
+    player->bytes += FRAME_SIZE;
+    return send_frame(fd, frame);
+}
+
+/**
+ * Play one match on a connected socket: swap READY, then take turns until a fleet is gone
+ *
+ * @param player The player
+ * @param fd     The connected socket
+ * @return 0 if the match finished, -1 if the connection failed
+ */
+static int play_match(player_t* player, int fd) {
+    // Turns are tiny messages, so don't let Nagle hold them back
+    int opt = 1;
+    player->syscalls++;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+    msg_conn_t conn;
+    msg_conn_init(&conn, fd);
+    board_t my_board, their_board;
+    uint8_t shots[BB_CELLS];
+    make_script(player, &my_board, shots);
+    initBoard(&their_board);
+
+    // Both players send READY once placed, then wait for the other's
+    frame_t frame = {.type = MSG_READY, .seat = 1 - player->seat, .ship = NO_SHIP};
+    if (player_send(player, fd, &frame) == -1) return -1;
+    if (receive_frame(&conn, &frame) == -1 || frame.type != MSG_READY) return -1;
+
+    int next_shot = 0;
+    bool my_turn = player->seat == 0;
+    int rc = 0;
+    while (rc == 0) {
+        if (my_turn) {
+            int cell = shots[next_shot++];
+            frame_t attack = {.type = MSG_ATTACK, .seat = player->seat, .target = 1 - player->seat,
+                              .x = cell % NCOLS + 1, .y = cell / NCOLS + 1, .ship = NO_SHIP};
+            player->turns++;
+            if (player_send(player, fd, &attack) == -1 || receive_frame(&conn, &frame) == -1 ||
+                frame.type != MSG_RESULT) {
+                rc = -1;
+                break;
+            }
+            board_mark_guess(&their_board, frame.x, frame.y, frame.outcome != RESULT_MISS);
+            if (frame.outcome == RESULT_SUNK) board_mark_sunk(&their_board, frame.ship);
+            if (their_board.shipsSunk == NDIFSHIPS) break;
+        } else {
+            if (receive_frame(&conn, &frame) == -1 || frame.type != MSG_ATTACK) {
+                rc = -1;
+                break;
+            }
+            guess_result_t guess = board_guess(&my_board, frame.x, frame.y);
+            frame_t result = {.type = MSG_RESULT, .seat = frame.seat, .target = player->seat, .x = frame.x,
+                              .y = frame.y, .ship = NO_SHIP};
+            result.outcome = guess == GUESS_SUNK ? RESULT_SUNK : (guess == GUESS_HIT ? RESULT_HIT : RESULT_MISS);
+            if (guess == GUESS_SUNK) result.ship = board_ship_at(&my_board, frame.x, frame.y);
+            if (player_send(player, fd, &result) == -1) rc = -1;
+            if (my_board.shipsSunk == NDIFSHIPS) break;
+        }
+        my_turn = !my_turn;
+    }
+
+    player->syscalls += conn.reads;
+    return rc;
+}
+
+/**
+ * Player 1: accept each match's connection and play it
+ */
+static void* player1_loop(void* arg) {
+    player_t* player = arg;
+    for (int m = 0; m < player->matches; m++) {
+        player->syscalls++;
+        int fd = server_socket_accept(listen_fd);
+        if (fd == -1) {
+            perror("Failed to accept Player 2");
+            exit(EXIT_FAILURE);
+        }
+        if (play_match(player, fd) == -1) {
+            fprintf(stderr, "Player 1 lost the connection\n");
+            exit(EXIT_FAILURE);
+        }
+        player->syscalls++;
+        close(fd);
+    }
+    return NULL;
+}
+
+/**
+ * Player 2: connect for each match and play it, timing the whole match
+ */
+static void* player2_loop(void* arg) {
+    player_t* player = arg;
+    for (int m = 0; m < player->matches; m++) {
+        uint64_t start = now_ns();
+        player->syscalls += 2;  // socket and connect
+        int fd = socket_connect("127.0.0.1", port);
+        if (fd == -1) {
+            perror("Failed to connect to Player 1");
+            exit(EXIT_FAILURE);
+        }
+        if (play_match(player, fd) == -1) {
+            fprintf(stderr, "Player 2 lost the connection\n");
+            exit(EXIT_FAILURE);
+        }
+        player->syscalls++;
+        close(fd);
+        player->match_ns[m] = now_ns() - start;
+    }
+    return NULL;
+}
+
+/**
+ * Compare two times, for qsort
+ */
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Get the user + system CPU time of the whole process
+ *
+ * @return The time in nanoseconds
+ */
+static uint64_t cpu_ns() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000 +
+           (uint64_t)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000;
+}
+
+int main(int argc, char* argv[]) {
+    int matches = argc > 1 ? atoi(argv[1]) : 2000;
+    if (matches < 1) {
+        fprintf(stderr, "Usage: %s [matches]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    listen_fd = server_socket_open(&port);
+    if (listen_fd == -1 || listen(listen_fd, 1) == -1) {
+        perror("Failed to open server socket");
+        exit(EXIT_FAILURE);
+    }
+
+    player_t players[2] = {
+        {.seat = 0, .matches = matches},
+        {.seat = 1, .matches = matches, .match_ns = calloc(matches, sizeof(uint64_t))},
+    };
+    rng_seed(&players[0].rng, 1);
+    rng_seed(&players[1].rng, 2);
+    if (players[1].match_ns == NULL) {
+        perror("Failed to allocate match times");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t wall_start = now_ns();
+    uint64_t cpu_start = cpu_ns();
+    pthread_t threads[2];
+    if (pthread_create(&threads[0], NULL, player1_loop, &players[0]) != 0 ||
+        pthread_create(&threads[1], NULL, player2_loop, &players[1]) != 0) {
+        // One player can't play a match alone
+        fprintf(stderr, "Failed to start the player threads\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+    double cpu_us = (cpu_ns() - cpu_start) / 1e3;
+    double wall_us = (now_ns() - wall_start) / 1e3;
+    close(listen_fd);
+
+    unsigned long turns = players[0].turns + players[1].turns;
+    unsigned long syscalls = players[0].syscalls + players[1].syscalls;
+    unsigned long bytes = players[0].bytes + players[1].bytes;
+    uint64_t* match_ns = players[1].match_ns;
+    qsort(match_ns, matches, sizeof(uint64_t), compare_u64);
+
+    printf("{\n");
+    printf("  \"matches\": %d, \"turns_per_match\": %.1f,\n", matches, (double)turns / matches);
+    printf("  \"wall_us_per_match\": {\"mean\": %.1f, \"p50\": %.1f, \"p99\": %.1f},\n", wall_us / matches,
+           match_ns[matches / 2] / 1e3, match_ns[(size_t)(0.99 * (matches - 1))] / 1e3);
+    printf("  \"cpu_us_per_match\": %.1f,\n", cpu_us / matches);
+    printf("  \"syscalls_per_turn\": %.2f,\n", (double)syscalls / turns);
+    printf("  \"bytes_per_turn\": %.2f\n", (double)bytes / turns);
+    printf("}\n");
+
+    free(match_ns);
+    return 0;
+}
@@ -9,75 +9,151 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+// Set up the receive side of a connection on an open socket.
+void msg_conn_init(msg_conn_t* conn, int fd) {
+  conn->fd = fd;
+  conn->start = 0;
+  conn->end = 0;
+  conn->reads = 0;
+}
+
+// Read once from the connection's socket into its buffer.
+ssize_t msg_conn_fill(msg_conn_t* conn) {
+  // Slide any partial message to the front so the whole tail of the buffer is free
+  if (conn->start > 0) {
+    memmove(conn->buffer, conn->buffer + conn->start, conn->end - conn->start);
+    conn->end -= conn->start;
+    conn->start = 0;
+  }
+
+  // A full buffer means the peer sent more than a message's worth without us consuming it
+  if (conn->end == MESSAGE_BUFFER_SIZE) {
+    errno = ENOBUFS;
+    return -1;
+  }
+
+  ssize_t rc;
+  do {
+    conn->reads++;
+    rc = read(conn->fd, conn->buffer + conn->end, MESSAGE_BUFFER_SIZE - conn->end);
+  } while (rc == -1 && errno == EINTR);
+
+  if (rc > 0) conn->end += rc;
+  return rc;
+}
+
+// Consume len bytes that are already buffered, without reading from the socket.
+const uint8_t* msg_conn_take(msg_conn_t* conn, size_t len) {
+  if (conn->end - conn->start < len) return NULL;
+
+  const uint8_t* data = conn->buffer + conn->start;
+  conn->start += len;
+  return data;
+}
+
+// Append bytes that were received some other way (e.g. by io_uring) to the buffer.
+int msg_conn_push(msg_conn_t* conn, const void* data, size_t len) {
+  // Slide any partial message to the front to make room
+  if (conn->start > 0) {
+    memmove(conn->buffer, conn->buffer + conn->start, conn->end - conn->start);
+    conn->end -= conn->start;
+    conn->start = 0;
+  }
+
+  if (len > MESSAGE_BUFFER_SIZE - conn->end) {
+    errno = ENOBUFS;
+    return -1;
+  }
+
+  memcpy(conn->buffer + conn->end, data, len);
+  conn->end += len;
+  return 0;
+}
+
+// Read exactly len bytes into out, reading from the socket only when the buffer runs dry.
+int receive_bytes(msg_conn_t* conn, void* out, size_t len) {
+  if (len > MESSAGE_BUFFER_SIZE) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  // Keep reading until enough bytes are buffered
+  while (conn->end - conn->start < len) {
+    ssize_t rc = msg_conn_fill(conn);
+    if (rc == -1) return -1;
+
+    // The peer hung up partway through (or before) the message
+    if (rc == 0) {
+      errno = ECONNRESET;
+      return -1;
+    }
+  }
+
+  memcpy(out, msg_conn_take(conn, len), len);
+  return 0;
+}
+
 // Send a across a socket with a header that includes the message length.
-int send_message(int fd, char* message) {
+int send_message(int fd, const char* message) {
   // If the message is NULL, set errno to EINVAL and return an error
   if (message == NULL) {
     errno = EINVAL;
     return -1;
   }
 
-  // First, send the length of the message in a size_t
+  // Send the length of the message in a size_t, followed by the message, in one syscall
   size_t len = strlen(message);
-  if (write(fd, &len, sizeof(size_t)) != sizeof(size_t)) {
-    // Writing failed, so return an error
-    return -1;
-  }
-
-  // Now we can send the message. Loop until the entire message has been written.
-  size_t bytes_written = 0;
-  while (bytes_written < len) {
-    // Try to write the entire remaining message
-    ssize_t rc = write(fd, message + bytes_written, len - bytes_written);
-
-    // Did the write fail? If so, return an error
+  struct iovec iov[2] = {
+      {.iov_base = &len, .iov_len = sizeof(size_t)},
+      {.iov_base = (char*)message, .iov_len = len},
+  };
+
+  // Loop until everything has been written. This almost always takes one writev.
+  int iovcnt = 2;
+  struct iovec* next = iov;
+  while (iovcnt > 0) {
+    ssize_t rc = writev(fd, next, iovcnt);
+
+    // Did the write fail? If so, return an error (unless a signal just interrupted it)
+    if (rc == -1 && errno == EINTR) continue;
     if (rc <= 0) return -1;
 
-    // If there was no error, write returned the number of bytes written
-    bytes_written += rc;
+    // Skip past whatever was written
+    while (iovcnt > 0 && (size_t)rc >= next->iov_len) {
+      rc -= next->iov_len;
+      next++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      next->iov_base = (char*)next->iov_base + rc;
+      next->iov_len -= rc;
+    }
   }
 
   return 0;
 }
 
-// Receive a message from a socket and return the message string (which must be freed later)
-char* receive_message(int fd) {
+// Receive a message into a caller-provided buffer and null-terminate it.
+ssize_t receive_message(msg_conn_t* conn, char* buffer, size_t capacity) {
   // First try to read in the message length
   size_t len;
-  if (read(fd, &len, sizeof(size_t)) != sizeof(size_t)) {
+  if (receive_bytes(conn, &len, sizeof(size_t)) != 0) {
     // Reading failed. Return an error
-    return NULL;
+    return -1;
   }
 
-  // Now make sure the message length is reasonable
-  if (len > MAX_MESSAGE_LENGTH) {
+  // Now make sure the message length is reasonable and fits (with a null terminator)
+  if (len > MAX_MESSAGE_LENGTH || len + 1 > capacity) {
     errno = EINVAL;
-    return NULL;
-  }
-
-  // Allocate space for the message and a null terminator
-  char* result = malloc(len + 1);
-
-  // Try to read the message. Loop until the entire message has been read.
-  size_t bytes_read = 0;
-  while (bytes_read < len) {
-    // Try to read the entire remaining message
-    ssize_t rc = read(fd, result + bytes_read, len - bytes_read);
-
-    // Did the read fail? If so, return an error
-    if (rc <= 0) {
-      free(result);
-      return NULL;
-    }
-
-    // Update the number of bytes read
-    bytes_read += rc;
+    return -1;
   }
 
-  // Add a null terminator to the message
-  result[len] = '\0';
+  // Read the message body and add a null terminator
+  if (receive_bytes(conn, buffer, len) != 0) return -1;
+  buffer[len] = '\0';
 
-  return result;
+  return len;
 }
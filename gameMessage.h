@@ -4,12 +4,49 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
 #define MAX_MESSAGE_LENGTH 2048
 
-// Send a across a socket with a header that includes the message length. Returns non-zero value if
-// an error occurs.
-int send_message(int fd, char* message);
+// Receive buffer size for one connection: one full message plus its header
+#define MESSAGE_BUFFER_SIZE (sizeof(size_t) + MAX_MESSAGE_LENGTH)
+
+// A connection's receive side. Each read() pulls in as much as the socket has ready, so several
+// small messages usually arrive with one syscall, and the buffer is reused for the life of the
+// connection instead of allocating per message.
+typedef struct msg_conn {
+  int fd;
+  size_t start;  // first unconsumed byte in buffer
+  size_t end;    // one past the last buffered byte
+  unsigned long reads;  // read() calls made, for syscall accounting
+  uint8_t buffer[MESSAGE_BUFFER_SIZE];
+} msg_conn_t;
+
+// Set up the receive side of a connection on an open socket.
+void msg_conn_init(msg_conn_t* conn, int fd);
+
+// Read once from the connection's socket into its buffer. Returns the result of read(), so 0
+// means the peer hung up and -1 sets errno (EAGAIN on a non-blocking socket with nothing ready).
+ssize_t msg_conn_fill(msg_conn_t* conn);
+
+// Consume len bytes that are already buffered, without reading from the socket. Returns a
+// pointer to them (valid until the next fill), or NULL if fewer than len bytes are buffered.
+const uint8_t* msg_conn_take(msg_conn_t* conn, size_t len);
+
+// Append bytes that were received some other way (e.g. by io_uring) to the buffer, as if a
+// fill had read them. Returns 0 on success, or -1 with errno ENOBUFS if they don't fit.
+int msg_conn_push(msg_conn_t* conn, const void* data, size_t len);
+
+// Read exactly len bytes into out, reading from the socket only when the buffer runs dry.
+// Returns 0 on success or -1 on error; errno is ECONNRESET if the peer closed the connection.
+int receive_bytes(msg_conn_t* conn, void* out, size_t len);
+
+// Send a across a socket with a header that includes the message length. The header and body
+// go out in a single writev. Returns non-zero value if an error occurs.
+int send_message(int fd, const char* message);
 
-// Receive a message from a socket and return the message string (which must be freed later).
-// Returns NULL when an error occurs.
-char* receive_message(int fd);
+// Receive a message into a caller-provided buffer and null-terminate it. Returns the message
+// length, or -1 when an error occurs (including a message that does not fit in capacity).
+ssize_t receive_message(msg_conn_t* conn, char* buffer, size_t capacity);
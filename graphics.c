@@ -9,6 +9,7 @@
 #include <pthread.h>
 #include "graphics.h"
 #include "curses.h"
+#include "render.h"
 
 /**
  * Initializes the curses environment
@@ -20,6 +21,16 @@ void init_curses() {
     curs_set(1);         // Show the cursor
     keypad(stdscr, TRUE); // Enable special keys (e.g., arrows)
     mousemask(0, NULL);
+
+    //setup colors once for the whole program
+    start_color();
+    use_default_colors();
+    init_pair(COLOR_GREEN, COLOR_GREEN, -1);//Numbers & letters for coordinates
+    init_pair(COLOR_RED, COLOR_RED, -1);//Hits
+    init_pair(COLOR_BLUE, COLOR_BLUE, -1);//Misses
+    init_pair(COLOR_YELLOW, COLOR_YELLOW, -1);//Ships
+
+    refresh();           // Sync stdscr so reading keys from it never repaints over the windows
 }
 
 /**
@@ -32,7 +43,7 @@ void init_curses() {
  * @return A pointer to the created window.
  */
 WINDOW* create_board_window(int start_x, int start_y, const char* title) {
-    WINDOW* win = newwin(15, 35, start_x, start_y); // 10x10 grid + padding
+    WINDOW* win = newwin(BOARD_WINDOW_ROWS, BOARD_WINDOW_COLS, start_x, start_y); // grid + padding
     box(win, 0, 0);                                // Draw a border around the window
     mvwprintw(win, 0, 2, "[ %s ]", title);         // Add a title to the window
     // move(16, 0);
@@ -45,146 +56,149 @@ WINDOW* create_board_window(int start_x, int start_y, const char* title) {
  * Draws the player's board, showing ships and their current state.
  *
  * @param win   The window where the board will be drawn.
- * @param board The player's game board array.
+ * @param board The player's game board.
  */
-void draw_player_board(WINDOW* win, cell_t board[NROWS + 1][NCOLS + 1]) {
-    //setup colors
-    use_default_colors();
-    initscr();
-    start_color();
+void draw_player_board(WINDOW* win, const board_t* board) {
+    render_board(win, board, false);
+}
 
-    //setup indentation for printing to windows
-    int left_margin = 6;
-    int top_margin = 2;
-    int v_space_between_cells = 2;
+/**
+ * Draws the opponent's board, hiding ships and showing only guesses.
+ *
+ * @param win   The window where the board will be drawn.
+ * @param board The opponent's game board.
+ */
+void draw_opponent_board(WINDOW* win, const board_t* board) {
+    render_board(win, board, true);
+}
 
-    //make color pairs
-    init_pair(COLOR_GREEN, COLOR_GREEN, -1);//Numbers & letters for coordinates
-    init_pair(COLOR_RED, COLOR_RED, -1);//Hits
-    init_pair(COLOR_BLUE, COLOR_BLUE, -1);//Misses
-    init_pair(COLOR_YELLOW, COLOR_YELLOW, -1);//Ships
+//what one board cell looked like the last time it was painted
+typedef struct painted_cell {
+    char symbol;
+    short color;
+} painted_cell_t;
 
-    //loop through each cell and pick its symbol and color
-    for (int y = 0; y < NROWS + 1; y++) {
-        for (int x = 0; x < NCOLS + 1; x++) {
-            wattron(win, COLOR_PAIR(0));
-            int color = 0;
-            char symbol = '~'; // Default empty cell
-            //Letters
-            if(y==0){
-                wattroff(win, COLOR_PAIR(color));
-                wattron(win, COLOR_PAIR(COLOR_GREEN));
-                color = COLOR_GREEN;
-                if(x==0){
-                    symbol = ' ';
-                }else {
-                    symbol = 'A'+x-1;
-                }
-            }else if (x==0){
-                //Numbers
-                wattroff(win, COLOR_PAIR(color));
-                wattron(win, COLOR_PAIR(COLOR_GREEN));
-                color = COLOR_GREEN;
-                symbol = y+'0';
-            } else if (board[x][y].guessed) {
-                //hit
-                if(board[x][y].hit){
-                    symbol = 'H';
-                    wattroff(win, COLOR_PAIR(color));
-                    wattron(win, COLOR_PAIR(COLOR_RED));
-                    color=COLOR_RED;
-                }else{
-                    //miss
-                    symbol = 'M';
-                    wattroff(win, COLOR_PAIR(color));
-                    wattron(win, COLOR_PAIR(COLOR_BLUE));
-                    color = COLOR_BLUE;
-                }
-            //ship
-            } else if (board[x][y].occupied) {
-                symbol = 'S'; // Display ship
-                wattroff(win, COLOR_PAIR(color));
-                wattron(win, COLOR_PAIR(COLOR_YELLOW));
-                color = COLOR_YELLOW;
-            }
-            //':' is the character after 9 in ASCII, so this is the special handling for 10
-            if (symbol==':') {
-                mvwprintw(win, y + top_margin, x * v_space_between_cells + (left_margin-1), "%d  ", 10);
-            } else mvwprintw(win, y + top_margin, x * v_space_between_cells + left_margin, "%c  ", symbol); // Adjust cell spacing
-            wattroff(win, COLOR_PAIR(color));
+//the last frame painted into a board window, so repaints only touch cells that changed
+typedef struct board_frame {
+    WINDOW* win;
+    bool valid;
+    painted_cell_t cells[NROWS + 1][NCOLS + 1];
+} board_frame_t;
+
+#define MAX_BOARD_WINDOWS 4 // board windows whose last frame we remember
+
+static board_frame_t frames[MAX_BOARD_WINDOWS];
+
+/**
+ * Find the remembered frame of a board window, claiming an unused one the first time
+ *
+ * @param win The board window
+ * @return The frame, or NULL if too many windows are already remembered
+ */
+static board_frame_t* frame_for(WINDOW* win) {
+    for (int i = 0; i < MAX_BOARD_WINDOWS; i++) {
+        if (frames[i].win == win) return &frames[i];
+    }
+    for (int i = 0; i < MAX_BOARD_WINDOWS; i++) {
+        if (frames[i].win == NULL) {
+            frames[i].win = win;
+            frames[i].valid = false;
+            return &frames[i];
         }
     }
-    wrefresh(win);
+    return NULL;
 }
 
 /**
- * Draws the opponent's board, hiding ships and showing only guesses.
+ * Forget what was painted in a window, so the next paint redraws every cell. Needed whenever the
+ * window is cleared behind the painter's back.
  *
- * @param win   The window where the board will be drawn.
- * @param board The opponent's game board array.
+ * @param win The window
  */
-void draw_opponent_board(WINDOW* win, cell_t board[NROWS + 1][NCOLS + 1]) {
-    //setup colors
-    use_default_colors();
-    initscr();
-    start_color();
+void forget_board_frame(WINDOW* win) {
+    for (int i = 0; i < MAX_BOARD_WINDOWS; i++) {
+        if (frames[i].win == win) frames[i].valid = false;
+    }
+}
+
+/**
+ * Decide how one position of the board grid looks, including the coordinate labels in row and
+ * column 0
+ *
+ * @param board      The board
+ * @param x          Column, 0..NCOLS (0 is the row labels)
+ * @param y          Row, 0..NROWS (0 is the column labels)
+ * @param hide_ships true to draw the opponent's view (no ships)
+ * @return The symbol and color pair
+ */
+static painted_cell_t cell_look(const board_t* board, int x, int y, bool hide_ships) {
+    //numbers & letters of coordinates
+    if (y == 0) return (painted_cell_t){x == 0 ? ' ' : 'A' + x - 1, COLOR_GREEN};
+    if (x == 0) return (painted_cell_t){y + '0', COLOR_GREEN};
+
+    cell_t cell = board_cell(board, x, y);
+    if (isGuessed(cell)) {
+        //hit or miss
+        return hasBeenHit(cell) ? (painted_cell_t){'H', COLOR_RED} : (painted_cell_t){'M', COLOR_BLUE};
+    }
+    //ship
+    if (isOccupied(cell) && !hide_ships) return (painted_cell_t){'S', COLOR_YELLOW};
+    return (painted_cell_t){'~', 0}; // Default empty cell
+}
 
+/**
+ * Paint a board into its window, only touching the cells that changed since the last paint
+ *
+ * @param win        The board window
+ * @param board      The board
+ * @param hide_ships true to draw the opponent's view (no ships)
+ */
+static void paint_board(WINDOW* win, const board_t* board, bool hide_ships) {
     //setup indentation for printing to windows
     int left_margin = 6;
     int top_margin = 2;
     int v_space_between_cells = 2;
 
-    //make color pairs
-    init_pair(COLOR_GREEN, COLOR_GREEN, -1);//Numbers & letters for coordinates
-    init_pair(COLOR_RED, COLOR_RED, -1);//Hits
-    init_pair(COLOR_BLUE, COLOR_BLUE, -1);//Misses
+    board_frame_t* frame = frame_for(win);
 
-    //loop through every cell
     for (int y = 0; y < NROWS + 1; y++) {
         for (int x = 0; x < NCOLS + 1; x++) {
-            wattron(win, COLOR_PAIR(0));
-            int color = 0;
-            char symbol = '~'; // Default empty cell
-            //numbers & letters of coordinates
-            if(y==0){
-                //letters
-                wattroff(win, COLOR_PAIR(color));
-                wattron(win, COLOR_PAIR(COLOR_GREEN));
-                color = COLOR_GREEN;
-                if(x==0){
-                    symbol = ' ';
-                }else {
-                    symbol = 'A'+x-1;
-                }
-            }else if (x==0){
-                //numbers
-                wattroff(win, COLOR_PAIR(color));
-                wattron(win, COLOR_PAIR(COLOR_GREEN));
-                color = COLOR_GREEN;
-                symbol = y+'0';
-            } else if (board[x][y].guessed) {
-                if(board[x][y].hit){
-                    //hit
-                    symbol = 'H';
-                    wattroff(win, COLOR_PAIR(color));
-                    wattron(win, COLOR_PAIR(COLOR_RED));
-                    color=COLOR_RED;
-                }else{
-                    //miss
-                    symbol = 'M';
-                    wattroff(win, COLOR_PAIR(color));
-                    wattron(win, COLOR_PAIR(COLOR_BLUE));
-                    color = COLOR_BLUE;
-                }
-            } 
-            //':' is the character after 9 in ASCII, so this is the special handling for 10
-            if (symbol==':') {
-                mvwprintw(win, y + top_margin, x * v_space_between_cells + (left_margin-1), "%d  ", 10);
-            } else mvwprintw(win, y + top_margin, x * v_space_between_cells + left_margin, "%c  ", symbol); // Adjust cell spacing
-            wattroff(win, COLOR_PAIR(color));
+            painted_cell_t look = cell_look(board, x, y, hide_ships);
+            if (frame != NULL && frame->valid && frame->cells[y][x].symbol == look.symbol &&
+                frame->cells[y][x].color == look.color) {
+                continue;
+            }
+            if (frame != NULL) frame->cells[y][x] = look;
+
+            wattron(win, COLOR_PAIR(look.color));
+            //row numbers past 9 take two columns, so they start one to the left
+            if (x == 0 && y >= 10) {
+                mvwprintw(win, y + top_margin, x * v_space_between_cells + (left_margin-1), "%d ", y);
+            } else mvwprintw(win, y + top_margin, x * v_space_between_cells + left_margin, "%c ", look.symbol); // Adjust cell spacing
+            wattroff(win, COLOR_PAIR(look.color));
         }
     }
-    wrefresh(win);
+    if (frame != NULL) frame->valid = true;
+}
+
+/**
+ * Paints the player's board into its window (render thread only).
+ *
+ * @param win   The window where the board will be drawn.
+ * @param board The player's game board.
+ */
+void paint_player_board(WINDOW* win, const board_t* board) {
+    paint_board(win, board, false);
+}
+
+/**
+ * Paints the opponent's board into its window, hiding ships (render thread only).
+ *
+ * @param win   The window where the board will be drawn.
+ * @param board The opponent's game board.
+ */
+void paint_opponent_board(WINDOW* win, const board_t* board) {
+    paint_board(win, board, true);
 }
 
 /**
@@ -208,6 +222,7 @@ WINDOW* create_prompt_window(int start_x, int start_y) {
  * End the curses environment
  */
 void end_curses() {
+    render_stop(); // Draw anything still queued and stop the render thread
     endwin(); // End curses mode
 }
 
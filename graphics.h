@@ -15,6 +15,9 @@
 #include <stdbool.h>
 #include "board.h"
 
+#define BOARD_WINDOW_ROWS (NROWS + 5)       // board window height: the grid, its labels, and padding
+#define BOARD_WINDOW_COLS (2 * NCOLS + 15)  // board window width (15x35 on the classic board)
+
 /**
  * Initializes the curses environment
  */
@@ -32,20 +35,46 @@ void init_curses();
 WINDOW* create_board_window(int start_x, int start_y, const char* title);
 
 /**
- * Draws the player's board, showing ships and their current state.
+ * Draws the player's board, showing ships and their current state. The board is copied and
+ * drawn by the render thread.
+ *
+ * @param win   The window where the board will be drawn.
+ * @param board The player's game board.
+ */
+void draw_player_board(WINDOW* win, const board_t* board);
+
+/**
+ * Draws the opponent's board, hiding ships and showing only guesses. The board is copied and
+ * drawn by the render thread.
  *
  * @param win   The window where the board will be drawn.
- * @param board The player's game board array.
+ * @param board The opponent's game board.
  */
-void draw_player_board(WINDOW* win, cell_t board[NROWS + 1][NCOLS + 1]);
+void draw_opponent_board(WINDOW* win, const board_t* board);
 
 /**
- * Draws the opponent's board, hiding ships and showing only guesses.
+ * Paints the player's board into its window. Only the render thread calls this.
  *
  * @param win   The window where the board will be drawn.
- * @param board The opponent's game board array.
+ * @param board The player's game board.
+ */
+void paint_player_board(WINDOW* win, const board_t* board);
+
+/**
+ * Paints the opponent's board into its window, hiding ships. Only the render thread calls this.
+ *
+ * @param win   The window where the board will be drawn.
+ * @param board The opponent's game board.
+ */
+void paint_opponent_board(WINDOW* win, const board_t* board);
+
+/**
+ * Forget what was last painted in a board window, so the next paint redraws every cell. The
+ * render thread calls this when a window is erased.
+ *
+ * @param win The window
  */
-void draw_opponent_board(WINDOW* win, cell_t board[NROWS + 1][NCOLS + 1]);
+void forget_board_frame(WINDOW* win);
 
 /**
  * Creates a new window to display prompts and handle user input.
@@ -58,7 +87,7 @@ void draw_opponent_board(WINDOW* win, cell_t board[NROWS + 1][NCOLS + 1]);
 WINDOW* create_prompt_window(int start_x, int start_y);
 
 /**
- * End the curses environment
+ * End the curses environment, stopping the render thread first
  */
 void end_curses();
 
@@ -0,0 +1,580 @@
+/**
+ * Load generator for the match host - many headless bot clients playing real matches.
+ *
+ * Every bot speaks the same frame protocol as "./battleship client": it connects, places a random
+ * fleet, sends READY, and then shoots at random cells it hasn't tried yet while answering the
+ * opponents' shots from its own board. In matches with more than two players (a host started
+ * with a player count, matched with -n here) each attack goes to a random player still in, and
+ * every result the host fans out is recorded on the bot's view of that player's board. When a
+ * match ends the bot hangs up and reconnects for the next one, so the host sees a steady stream
+ * of new matches as well as turns.
+ *
+ * With -w, that many more connections watch the host's featured matches as spectators and count
+ * the events they receive, to see what a crowd of watchers does to the players' round trips.
+ *
+ * Bots are spread over a few threads, each running its own epoll loop. The time from sending an
+ * attack to receiving its result is recorded for every shot and reported as percentiles.
+ *
+ * Usage: battleship-loadgen [-h host] [-p port] [-c connections] [-t threads] [-d seconds] [-m matches]
+ *                           [-n players] [-w watchers]
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "gameMessage.h"
+#include "placement.h"
+#include "protocol.h"
+#include "socket.h"
+
+#define MAX_EVENTS 256  // events handled per epoll_wait call
+#define TICK_MS 100     // how often an idle thread checks whether the run is over
+
+//where a bot is in its match
+typedef enum bot_state {
+    BOT_WAITING,    // sent READY, waiting for the host to start the match
+    BOT_ATTACKING,  // sent an attack, waiting for its result
+    BOT_DEFENDING   // waiting for somebody else's attack (or its result)
+} bot_state_t;
+
+/**
+ * bot struct, stores one client connection and the match it is playing
+ */
+typedef struct bot {
+    int fd;
+    bool watcher;               // a spectator rather than a player
+    bot_state_t state;
+    int seat;
+    int players;                // seats in the match
+    int attacker;               // seat whose attack comes next
+    int target;                 // seat our outstanding attack is aimed at
+    int left;                   // seats still in the match
+    bool out[MAX_SEATS];        // seats whose fleet is gone or whose player left
+    board_t my_board;
+    board_t views[MAX_SEATS];   // our view of every other seat's board
+    uint8_t shots[BB_CELLS];    // cells to shoot at, in random order (bit indexes)
+    int next_shot[MAX_SEATS];   // how far into shots we are on each seat's board
+    uint64_t sent_ns;           // when the outstanding attack was sent
+    rng_t rng;
+    msg_conn_t rx;
+} bot_t;
+
+/**
+ * worker struct, stores one thread's bots and what they measured
+ */
+typedef struct worker {
+    pthread_t thread;
+    int epoll_fd;
+    bot_t* bots;
+    int nbots;
+    unsigned long matches;      // matches finished (counted by the winning bot, so once per match)
+    unsigned long turns;        // attacks sent
+    unsigned long aborted;      // matches that ended without a winner
+    unsigned long watched;      // frames received by spectators
+    uint64_t* latencies;        // attack-to-result round trips, in ns
+    size_t nlatencies;
+    size_t latency_capacity;
+} worker_t;
+
+//run settings, shared read-only by every worker
+static const char* host = "localhost";
+static unsigned short port = 0;
+static uint64_t deadline_ns;
+static unsigned long match_limit = 0;       // 0 means run until the deadline
+
+//finished matches across all workers, for -m
+static atomic_ulong total_matches;
+
+//socket_connect uses gethostbyname, which isn't thread safe
+static pthread_mutex_t connect_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Read the monotonic clock
+ *
+ * @return The time in nanoseconds
+ */
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Check whether the run is over
+ */
+static bool run_over() {
+    if (match_limit > 0 && atomic_load_explicit(&total_matches, memory_order_relaxed) >= match_limit) return true;
+    return now_ns() >= deadline_ns;
+}
+
+/**
+ * Remember one shot's round trip
+ *
+ * @param worker The worker that measured it
+ * @param ns     The round trip in nanoseconds
+ */
+static void record_latency(worker_t* worker, uint64_t ns) {
+    if (worker->nlatencies == worker->latency_capacity) {
+        size_t capacity = worker->latency_capacity == 0 ? 4096 : worker->latency_capacity * 2;
+        uint64_t* grown = realloc(worker->latencies, capacity * sizeof(uint64_t));
+        if (grown == NULL) return;
+        worker->latencies = grown;
+        worker->latency_capacity = capacity;
+    }
+    worker->latencies[worker->nlatencies++] = ns;
+}
+
+/**
+ * Connect a bot to the host and start a new match: place a fleet, shuffle our shots, send READY
+ *
+ * @param worker The bot's worker
+ * @param bot    The bot
+ * @return 0 on success, -1 if the host couldn't be reached
+ */
+static int bot_connect(worker_t* worker, bot_t* bot) {
+    pthread_mutex_lock(&connect_mutex);
+    bot->fd = socket_connect((char*)host, port);
+    pthread_mutex_unlock(&connect_mutex);
+    if (bot->fd == -1) return -1;
+
+    // Turns are tiny messages, so don't let Nagle hold them back
+    int opt = 1;
+    setsockopt(bot->fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    // Reads are non-blocking, and so are sends: a bot writes at most two frames per turn into a
+    // send buffer that is otherwise empty, so a full one means the host has stalled, and a failed
+    // send_frames (which may have left part of a frame behind) hangs the bot up
+    fcntl(bot->fd, F_SETFL, fcntl(bot->fd, F_GETFL, 0) | O_NONBLOCK);
+    msg_conn_init(&bot->rx, bot->fd);
+
+    struct epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP, .data.ptr = bot};
+    epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, bot->fd, &ev);
+    if (bot->watcher) {
+        frame_t watch = {.type = MSG_WATCH, .ship = NO_SHIP};
+        return send_frame(bot->fd, &watch);
+    }
+
+    board_random_fleet(&bot->my_board, &bot->rng);
+    for (int i = 0; i < BB_CELLS; i++) {
+        int j = rng_below(&bot->rng, i + 1);
+        bot->shots[i] = bot->shots[j];
+        bot->shots[j] = i;
+    }
+    bot->state = BOT_WAITING;
+
+    frame_t ready = {.type = MSG_READY, .ship = NO_SHIP};
+    return send_frame(bot->fd, &ready);
+}
+
+/**
+ * Hang up, and start the next match unless the run is over
+ *
+ * @param worker The bot's worker
+ * @param bot    The bot
+ */
+static void bot_restart(worker_t* worker, bot_t* bot) {
+    if (bot->fd != -1) {
+        epoll_ctl(worker->epoll_fd, EPOLL_CTL_DEL, bot->fd, NULL);
+        close(bot->fd);
+        bot->fd = -1;
+    }
+    if (run_over()) return;
+    if (bot_connect(worker, bot) == -1) {
+        perror("Failed to connect to host");
+        if (bot->fd != -1) close(bot->fd);
+        bot->fd = -1;
+    }
+}
+
+/**
+ * Build our next attack: a random player still in, at the next cell of our shuffled order that
+ * nobody has shot at on their board yet
+ *
+ * @param bot    The bot
+ * @param attack The frame to fill in
+ */
+static void bot_aim(bot_t* bot, frame_t* attack) {
+    int targets[MAX_SEATS];
+    int ntargets = 0;
+    for (int seat = 0; seat < bot->players; seat++) {
+        if (seat != bot->seat && !bot->out[seat]) targets[ntargets++] = seat;
+    }
+    bot->target = targets[rng_below(&bot->rng, ntargets)];
+
+    // A board with ships left always has a cell nobody has tried
+    const board_t* view = &bot->views[bot->target];
+    int cell;
+    do {
+        cell = bot->shots[bot->next_shot[bot->target]++];
+    } while (bb_test(&view->guessed, cell % NCOLS + 1, cell / NCOLS + 1));
+
+    *attack = (frame_t){.type = MSG_ATTACK, .seat = bot->seat, .target = bot->target,
+                        .x = cell % NCOLS + 1, .y = cell / NCOLS + 1, .ship = NO_SHIP};
+}
+
+/**
+ * Find the seat that attacks after another one, the same way the host does
+ *
+ * @param bot  The bot, in a match with at least one other seat still in it
+ * @param seat The seat that just attacked (it may be out by now)
+ * @return The next seat in order that is still in the match
+ */
+static int bot_next_seat(const bot_t* bot, int seat) {
+    do {
+        seat = (seat + 1) % bot->players;
+    } while (bot->out[seat]);
+    return seat;
+}
+
+/**
+ * Take a seat out of the bot's match
+ *
+ * @param bot  The bot
+ * @param seat The seat whose fleet is gone or whose player left
+ */
+static void bot_eliminate(bot_t* bot, int seat) {
+    if (bot->out[seat]) return;
+    bot->out[seat] = true;
+    bot->left--;
+}
+
+/**
+ * Record the result of an attack on our view of the target's board, and move on to the next
+ * attacker (unless the attacker has left, which moved the turn on already)
+ *
+ * @param bot   The bot
+ * @param frame The RESULT frame
+ */
+static void bot_record(bot_t* bot, const frame_t* frame) {
+    board_t* view = &bot->views[frame->target];
+    board_mark_guess(view, frame->x, frame->y, frame->outcome != RESULT_MISS);
+    if (frame->outcome == RESULT_SUNK) board_mark_sunk(view, frame->ship);
+    if (view->shipsSunk == NDIFSHIPS) bot_eliminate(bot, frame->target);
+    if (!bot->out[frame->seat]) bot->attacker = bot_next_seat(bot, bot->attacker);
+}
+
+/**
+ * Count a match we won (the winner counts it, so it's counted once)
+ *
+ * @param worker The bot's worker
+ */
+static void bot_won(worker_t* worker) {
+    worker->matches++;
+    atomic_fetch_add_explicit(&total_matches, 1, memory_order_relaxed);
+}
+
+/**
+ * Send frames and, if the last one is an attack, start timing it
+ *
+ * @param worker The bot's worker
+ * @param bot    The bot
+ * @param frames The frames to send
+ * @param count  Number of frames
+ * @return 0 on success, -1 on error
+ */
+static int bot_send(worker_t* worker, bot_t* bot, const frame_t* frames, size_t count) {
+    if (frames[count - 1].type == MSG_ATTACK) {
+        worker->turns++;
+        bot->state = BOT_ATTACKING;
+        bot->sent_ns = now_ns();
+    }
+    return send_frames(bot->fd, frames, count);
+}
+
+/**
+ * Advance a bot's match with one frame from the host
+ *
+ * @param worker The bot's worker
+ * @param bot    The bot
+ * @param frame  The frame
+ * @return false if the match is over and the bot should hang up
+ */
+static bool bot_handle(worker_t* worker, bot_t* bot, const frame_t* frame) {
+    frame_t attack;
+
+    if (bot->watcher) {
+        worker->watched++;
+        return true;
+    }
+
+    if (frame->type == MSG_READY && bot->state == BOT_WAITING) {
+        // Seat 0 shoots first
+        bot->seat = frame->seat;
+        bot->players = frame->target != 0 ? frame->target : 2;
+        bot->attacker = 0;
+        bot->left = bot->players;
+        for (int seat = 0; seat < bot->players; seat++) {
+            bot->out[seat] = false;
+            bot->next_shot[seat] = 0;
+            initBoard(&bot->views[seat]);
+        }
+        bot->state = BOT_DEFENDING;
+        if (bot->seat != 0) return true;
+        bot_aim(bot, &attack);
+        return bot_send(worker, bot, &attack, 1) == 0;
+    }
+
+    if (frame->type == MSG_RESULT && frame->target != bot->seat && bot->state != BOT_WAITING) {
+        // Our own result, or one the host fanned out to everybody
+        if (bot->state == BOT_ATTACKING && frame->seat == bot->seat) {
+            record_latency(worker, now_ns() - bot->sent_ns);
+            bot->state = BOT_DEFENDING;
+        }
+        bot_record(bot, frame);
+        if (bot->left == 1) {
+            bot_won(worker);
+            return false;
+        }
+        // The late result of a shot whose attacker left can sink our target's last ship before our
+        // shot reaches it; the host calls our shot off, so shoot again
+        if (bot->state == BOT_ATTACKING && frame->seat != bot->seat && bot->out[bot->target]) {
+            bot_aim(bot, &attack);
+            return bot_send(worker, bot, &attack, 1) == 0;
+        }
+        if (bot->attacker != bot->seat || bot->state == BOT_ATTACKING) return true;
+        bot_aim(bot, &attack);
+        return bot_send(worker, bot, &attack, 1) == 0;
+    }
+
+    if (frame->type == MSG_ATTACK && bot->state == BOT_DEFENDING) {
+        // Answer the shot, and if we're next, shoot in the same write
+        guess_result_t guess = board_guess(&bot->my_board, frame->x, frame->y);
+        frame_t replies[2];
+        replies[0] = (frame_t){.type = MSG_RESULT, .seat = frame->seat, .target = bot->seat, .x = frame->x,
+                               .y = frame->y, .ship = NO_SHIP};
+        replies[0].outcome = guess == GUESS_SUNK ? RESULT_SUNK : (guess == GUESS_HIT ? RESULT_HIT : RESULT_MISS);
+        if (guess == GUESS_SUNK) replies[0].ship = board_ship_at(&bot->my_board, frame->x, frame->y);
+
+        if (bot->my_board.shipsSunk == NDIFSHIPS) {
+            send_frame(bot->fd, &replies[0]);
+            return false;
+        }
+        bot->attacker = bot_next_seat(bot, bot->attacker);
+        if (bot->attacker != bot->seat) return send_frame(bot->fd, &replies[0]) == 0;
+        bot_aim(bot, &replies[1]);
+        return bot_send(worker, bot, replies, 2) == 0;
+    }
+
+    if (frame->type == MSG_QUIT && bot->state != BOT_WAITING && bot->left > 2) {
+        // Somebody left a match that goes on; if they were next, or were our target, the turn moves on
+        bot_eliminate(bot, frame->seat);
+        if (frame->seat == bot->attacker) bot->attacker = bot_next_seat(bot, frame->seat);
+        if (bot->state == BOT_ATTACKING && frame->seat != bot->target) return true;
+        if (bot->attacker != bot->seat) return true;
+        bot_aim(bot, &attack);
+        return bot_send(worker, bot, &attack, 1) == 0;
+    }
+
+    // QUIT that ends the match, or anything out of turn
+    worker->aborted++;
+    return false;
+}
+
+/**
+ * Read everything a bot's socket has and handle each complete frame
+ *
+ * @param worker The bot's worker
+ * @param bot    The readable bot
+ */
+static void bot_read(worker_t* worker, bot_t* bot) {
+    while (true) {
+        ssize_t rc = msg_conn_fill(&bot->rx);
+        if (rc == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (rc <= 0) {
+            // The host hung up, e.g. after the winning shot
+            bot_restart(worker, bot);
+            return;
+        }
+
+        const uint8_t* data;
+        while ((data = msg_conn_take(&bot->rx, FRAME_SIZE)) != NULL) {
+            frame_t frame;
+            if (decode_frame(data, &frame) == -1 || !bot_handle(worker, bot, &frame)) {
+                bot_restart(worker, bot);
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Worker thread: connect this worker's bots and play matches until the run is over
+ */
+static void* worker_loop(void* arg) {
+    worker_t* worker = arg;
+    for (int i = 0; i < worker->nbots; i++) {
+        bot_restart(worker, &worker->bots[i]);
+    }
+
+    struct epoll_event events[MAX_EVENTS];
+    while (!run_over()) {
+        int n = epoll_wait(worker->epoll_fd, events, MAX_EVENTS, TICK_MS);
+        if (n == -1 && errno != EINTR) {
+            perror("epoll_wait failed");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            bot_t* bot = events[i].data.ptr;
+            if (bot->fd != -1) bot_read(worker, bot);
+        }
+    }
+
+    for (int i = 0; i < worker->nbots; i++) {
+        if (worker->bots[i].fd != -1) close(worker->bots[i].fd);
+    }
+    return NULL;
+}
+
+/**
+ * Compare two latencies, for qsort
+ */
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Get a percentile of sorted latencies, in microseconds
+ */
+static double percentile_us(const uint64_t* sorted, size_t n, double p) {
+    if (n == 0) return 0;
+    size_t i = (size_t)(p * (n - 1));
+    return sorted[i] / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    int connections = 64;
+    int watchers = 0;
+    int players = 2;
+    int threads = 1;
+    double seconds = 10;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:c:t:d:m:n:w:")) != -1) {
+        switch (opt) {
+            case 'h': host = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'c': connections = atoi(optarg); break;
+            case 't': threads = atoi(optarg); break;
+            case 'd': seconds = atof(optarg); break;
+            case 'm': match_limit = strtoul(optarg, NULL, 10); break;
+            case 'n': players = atoi(optarg); break;
+            case 'w': watchers = atoi(optarg); break;
+            default:
+                fprintf(stderr,
+                        "Usage: %s [-h host] -p port [-c connections] [-t threads] [-d seconds] [-m matches] [-n players]"
+                        " [-w watchers]\n",
+                        argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+    if (players < 2 || players > MAX_SEATS) {
+        fprintf(stderr, "Players per match (-n) has to be 2 to %d, the same as the host's.\n", MAX_SEATS);
+        exit(EXIT_FAILURE);
+    }
+    if (port == 0 || connections < players || connections % players != 0 || watchers < 0 || threads < 1 ||
+        seconds <= 0) {
+        fprintf(stderr, "Need a port (-p), connections (-c) in whole matches of %d, at least one thread, and a duration.\n",
+                players);
+        exit(EXIT_FAILURE);
+    }
+    int total = connections + watchers;
+    if (threads > total) threads = total;
+
+    printf("Playing %d-player matches against %s:%u with %d connections and %d watchers on %d threads...\n", players,
+           host, port, connections, watchers, threads);
+    fflush(stdout);
+
+    // Spread the bots over the workers, with the watchers evenly among the players
+    bot_t* bots = calloc(total, sizeof(bot_t));
+    worker_t* workers = calloc(threads, sizeof(worker_t));
+    if (bots == NULL || workers == NULL) {
+        perror("Failed to allocate bots");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < total; i++) {
+        bots[i].fd = -1;
+        bots[i].watcher = (long)(i + 1) * watchers / total != (long)i * watchers / total;
+        rng_seed(&bots[i].rng, i + 1);
+    }
+
+    uint64_t start = now_ns();
+    deadline_ns = start + (uint64_t)(seconds * 1e9);
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        worker_t* worker = &workers[t];
+        int first = total * t / threads;
+        worker->bots = &bots[first];
+        worker->nbots = total * (t + 1) / threads - first;
+        worker->epoll_fd = epoll_create1(0);
+        if (worker->epoll_fd == -1) {
+            perror("Failed to create epoll instance");
+            exit(EXIT_FAILURE);
+        }
+        if (pthread_create(&worker->thread, NULL, worker_loop, worker) != 0) {
+            close(worker->epoll_fd);
+            break;
+        }
+        started++;
+    }
+    if (started == 0) {
+        fprintf(stderr, "Failed to start any worker threads\n");
+        exit(EXIT_FAILURE);
+    }
+    if (started < threads) {
+        // Carry on with the workers that did start; the other workers' bots never connect
+        fprintf(stderr, "Only started %d of %d worker threads\n", started, threads);
+        threads = started;
+    }
+
+    // Add up what every worker measured
+    unsigned long matches = 0, turns = 0, aborted = 0, watched = 0;
+    size_t nlatencies = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+        close(workers[t].epoll_fd);
+        matches += workers[t].matches;
+        turns += workers[t].turns;
+        aborted += workers[t].aborted;
+        watched += workers[t].watched;
+        nlatencies += workers[t].nlatencies;
+    }
+    double elapsed = (now_ns() - start) / 1e9;
+
+    uint64_t* latencies = malloc((nlatencies + 1) * sizeof(uint64_t));
+    size_t n = 0;
+    for (int t = 0; t < threads; t++) {
+        if (latencies != NULL && workers[t].nlatencies > 0) {
+            memcpy(latencies + n, workers[t].latencies, workers[t].nlatencies * sizeof(uint64_t));
+            n += workers[t].nlatencies;
+        }
+        free(workers[t].latencies);
+    }
+    if (latencies != NULL) qsort(latencies, n, sizeof(uint64_t), compare_u64);
+
+    printf("%.2f s: %lu matches (%.1f matches/s), %lu turns (%.1f turns/s), %lu aborted\n", elapsed, matches,
+           matches / elapsed, turns, turns / elapsed, aborted);
+    printf("shot round trip: p50 %.1f us, p99 %.1f us, p999 %.1f us over %zu shots\n", percentile_us(latencies, n, 0.5),
+           percentile_us(latencies, n, 0.99), percentile_us(latencies, n, 0.999), n);
+    if (watchers > 0) {
+        printf("spectators: %lu events received (%.1f per watcher per second)\n", watched,
+               watched / elapsed / watchers);
+    }
+
+    free(latencies);
+    free(workers);
+    free(bots);
+    return 0;
+}
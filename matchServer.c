@@ -0,0 +1,1318 @@
+/**
+ * Match host - seats incoming clients into matches and relays every match from one event loop.
+ *
+ * Each connection keeps its own receive and send buffers, so a slow or partial read/write on
+ * one socket never blocks any other match. A match moves through PLACING -> ATTACK <-> RESULT
+ * -> OVER as messages arrive; the host only checks that the right seat is talking at the right
+ * time, sends each attack to its target, and sends each result to every other seat.
+ *
+ * Nothing is written while frames are being handled. A frame for a player is appended to that
+ * connection's send buffer and the connection is marked dirty; once the event loop's pass is
+ * done, every dirty connection is flushed with one write (or one send SQE). A result fanned out
+ * to a 16-seat match costs 15 writes, one per player, however many frames each player got from
+ * that pass, so a turn's cost grows with the number of players rather than its square.
+ *
+ * Spectators watch one featured match at a time. Its public events (results and quits) are
+ * encoded once into the feed, a chain of reference-counted chunks that every spectator reads
+ * from; a spectator is just a cursor into the chain, so a hundred watchers cost a hundred writes
+ * of shared bytes and no copies. A spectator that joins mid-match starts at the match's WATCH
+ * frame and catches up with writes that gather several chunks at once. Players are always flushed first, and spectators
+ * get at most FEED_SENDS_PER_PASS writes per pass, so a crowd of them can't hold up a turn; the
+ * rest are served on the next pass. One that falls more than FEED_MAX_LAG bytes behind isn't
+ * reading and is dropped, and chunks every cursor has passed are freed.
+ *
+ * The match logic doesn't care how bytes move. The epoll backend reads and writes with plain
+ * syscalls when sockets are ready. The io_uring backend keeps one multishot accept and one
+ * multishot recv per connection in flight, queues sends as SQEs, and submits everything a pass
+ * over the completion queue produced with a single io_uring_enter.
+ */
+
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "matchServer.h"
+
+#ifdef __linux__
+
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+
+#include "board.h"
+#include "protocol.h"
+#include "socket.h"
+#include "uring.h"
+
+#define MAX_EVENTS 256                      // events handled per epoll_wait call
+#define TX_BUFFER_SIZE (64 * FRAME_SIZE)    // pending outgoing bytes per connection
+#define URING_ENTRIES 4096                  // io_uring submission queue size
+#define URING_CQ_ENTRIES 16384              // io_uring completion queue size
+#define URING_BUFFERS 4096                  // provided receive buffers (power of two)
+#define URING_BUFFER_SIZE 256               // size of each provided receive buffer
+#define URING_BGID 1                        // buffer group id of the provided buffers
+#define FEED_CHUNK_SIZE (64 * FRAME_SIZE)   // bytes per chunk of the spectator feed
+#define FEED_IOVS 8                         // feed chunks gathered into one spectator write
+#define FEED_MAX_LAG (64 * 1024)            // feed bytes a spectator may fall behind before it's dropped
+#define FEED_SENDS_PER_PASS 64              // spectator writes per pass of the event loop
+#define FEED_SOCKET_BUFFER (16 * 1024)      // kernel send buffer of a spectator's socket
+
+// A spectator joining at the start of the longest possible match mustn't count as behind
+_Static_assert((MAX_SEATS * (NROWS * NCOLS + 1) + 1) * FRAME_SIZE <= FEED_MAX_LAG, "a whole match fits in the lag");
+
+//what an io_uring completion was for, kept in the low bits of its user_data
+#define OP_RECV 0
+#define OP_SEND 1
+#define OP_MASK 3
+#define ACCEPT_USER_DATA 0                  // the listening socket's multishot accept
+
+//states of a single match
+typedef enum match_state {
+    MATCH_PLACING,  // filling up with players that have sent READY
+    MATCH_ATTACK,   // waiting for the attacker's coordinates
+    MATCH_RESULT,   // waiting for the defender to report the result
+    MATCH_OVER      // one seat is left (or a player quit), waiting for the players to hang up
+} match_state_t;
+
+struct match;
+
+/**
+ * feed_chunk struct, stores a run of encoded feed frames. A chunk is referenced by the chunk
+ * before it (or by the feed's start), and by every spectator whose cursor is in it; it's freed
+ * when the last reference goes.
+ */
+typedef struct feed_chunk {
+    int refs;
+    size_t len;                 // bytes of data in use; every chunk but the last is full
+    struct feed_chunk* next;
+    uint8_t data[FEED_CHUNK_SIZE];
+} feed_chunk_t;
+
+/**
+ * connection struct, stores one client socket, its seat in a match (or its place in the feed),
+ * and its I/O buffers
+ */
+typedef struct connection {
+    int fd;
+    struct match* match;
+    int seat;                   // 0 is Player 1 (shoots first), 1 is Player 2, and so on
+    bool spectator;             // sent WATCH: reads the feed instead of playing
+    bool feed_queued;           // spectator waiting in server->feed_queue for its turn to write
+    bool write_armed;           // EPOLLOUT is registered because tx is backed up
+    bool dirty;                 // has output queued since the last flush
+    bool overflow;              // queued more than tx holds; closed at the next flush
+    size_t tx_inflight;         // io_uring: bytes at the front of tx owned by an in-flight send
+    int ops;                    // io_uring: requests still in flight that point at this connection
+    struct connection* next_closed;
+    struct connection* next_dirty;
+    struct connection* next_feed;
+    size_t spectator_index;     // position in server->spectators
+    feed_chunk_t* feed_chunk;   // spectator: the next bytes to send are at feed_chunk->data + feed_off
+    size_t feed_off;
+    uint64_t feed_pos;          // spectator: feed bytes sent so far
+    struct iovec feed_iov[FEED_IOVS];   // the chunks an in-flight io_uring send points at
+    struct msghdr feed_msg;
+    size_t tx_len;
+    uint8_t tx[TX_BUFFER_SIZE];
+    msg_conn_t rx;              // reusable receive buffer
+} connection_t;
+
+/**
+ * match struct, stores the seats and whose move the host is waiting for
+ */
+typedef struct match {
+    connection_t* seats[MAX_SEATS]; // NULL once that player has hung up
+    int nseats;
+    match_state_t state;
+    int attacker;               // seat whose coordinates we're waiting for (or waiting on the result of)
+    int defender;               // seat the attacker is shooting at
+    int stale;                  // seat whose next RESULT answers a cancelled attack, or -1
+    int stale_attacker;         // seat that made that attack and left
+    int alive;                  // seats still in the match
+    bool out[MAX_SEATS];        // seats whose fleet is gone or whose player left
+    int sunk[MAX_SEATS];        // ships sunk on each seat's board
+} match_t;
+
+/**
+ * match_server struct, stores the event loop state shared by every match
+ */
+typedef struct match_server {
+    server_backend_t backend;
+    int epoll_fd;
+    int listen_fd;
+#ifdef HAVE_IO_URING
+    uring_t ring;
+    uring_buf_ring_t buffers;
+    bool accept_paused;         // the accept failed for lack of descriptors; re-armed when a connection closes
+#endif
+    int players;                // seats per match
+    match_t* forming;           // match still waiting for players to join
+    connection_t* dirty;        // connections with output queued during this pass
+    match_t* featured;          // match the spectators are watching, or NULL until the next one starts
+    feed_chunk_t* feed_start;   // chunk holding the featured match's WATCH frame (a reference)
+    size_t feed_start_off;
+    uint64_t feed_start_pos;
+    feed_chunk_t* feed_tail;    // chunk new events go into
+    uint64_t feed_pos;          // bytes ever added to the feed
+    bool feed_fresh;            // events were added during this pass
+    connection_t** spectators;
+    size_t nspectators;
+    size_t spectator_capacity;
+    connection_t* feed_queue;   // spectators with feed bytes to write, oldest first
+    connection_t* feed_queue_tail;
+    unsigned long spectators_watched;
+    unsigned long spectators_dropped;
+    connection_t* closed;       // closed connections, freed once nothing can refer to them
+    size_t open_connections;
+    size_t open_matches;
+    size_t finished_matches;
+    unsigned long turns;        // attacks relayed
+    unsigned long syscalls;     // syscalls made by the event loop
+} match_server_t;
+
+//set by SIGINT/SIGTERM to stop the event loop and print statistics
+static volatile sig_atomic_t stop_requested = false;
+
+static void conn_close(match_server_t* server, connection_t* conn);
+#ifdef HAVE_IO_URING
+static int uring_arm_accept(match_server_t* server);
+#endif
+
+/**
+ * Put a file descriptor into non-blocking mode
+ *
+ * @param fd The file descriptor
+ * @return 0 on success, -1 on failure
+ */
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags == -1) return -1;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+/**
+ * Change the set of events epoll reports for a connection
+ *
+ * @param server The match server
+ * @param conn   The connection to update
+ * @param write  True to also wait for the socket to become writable
+ */
+static void conn_arm(match_server_t* server, connection_t* conn, bool write) {
+    if (conn->write_armed == write) return;
+    server->syscalls++;
+    struct epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP | (write ? EPOLLOUT : 0), .data.ptr = conn};
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, conn->fd, &ev);
+    conn->write_armed = write;
+}
+
+/**
+ * Drop a reference to a feed chunk, freeing it (and every chunk after it that only it held) once
+ * nothing refers to it
+ *
+ * @param chunk The chunk
+ */
+static void feed_release(feed_chunk_t* chunk) {
+    while (chunk != NULL && --chunk->refs == 0) {
+        feed_chunk_t* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+/**
+ * Encode a frame onto the end of the feed. Spectators pick it up when the pass is done (see
+ * flush_feed). If there's no memory for another chunk the feed would go on with a hole in it,
+ * so every spectator is hung up on and the match stops being featured instead.
+ *
+ * @param server The match server
+ * @param frame  The frame
+ * @return 0 on success, -1 if the frame couldn't be added
+ */
+static int feed_append(match_server_t* server, const frame_t* frame) {
+    feed_chunk_t* tail = server->feed_tail;
+    if (tail->len == FEED_CHUNK_SIZE) {
+        feed_chunk_t* chunk = calloc(1, sizeof(feed_chunk_t));
+        if (chunk == NULL) {
+            perror("Failed to grow the spectator feed");
+            // Backwards, since dropping a spectator moves the last one into its place
+            for (size_t i = server->nspectators; i-- > 0;) {
+                conn_close(server, server->spectators[i]);
+            }
+            server->featured = NULL;
+            return -1;
+        }
+        chunk->refs = 1;
+        tail->next = chunk;
+        server->feed_tail = tail = chunk;
+    }
+    encode_frame(frame, tail->data + tail->len);
+    tail->len += FRAME_SIZE;
+    server->feed_pos += FRAME_SIZE;
+    server->feed_fresh = true;
+    return 0;
+}
+
+/**
+ * Move a spectator's cursor forward, onto the next chunk whenever it has used one up
+ *
+ * @param conn  The spectator
+ * @param bytes Number of bytes it has sent
+ */
+static void feed_advance(connection_t* conn, size_t bytes) {
+    conn->feed_pos += bytes;
+    conn->feed_off += bytes;
+    while (conn->feed_off >= conn->feed_chunk->len && conn->feed_chunk->next != NULL) {
+        feed_chunk_t* chunk = conn->feed_chunk;
+        conn->feed_off -= chunk->len;
+        conn->feed_chunk = chunk->next;
+        conn->feed_chunk->refs++;
+        feed_release(chunk);
+    }
+}
+
+/**
+ * Write as much of the feed as a spectator hasn't had yet as its socket will take right now,
+ * gathering up to FEED_IOVS chunks into each write
+ *
+ * @param server The match server
+ * @param conn   The spectator
+ * @return 0 on success, -1 if the connection failed (the caller closes it)
+ */
+static int feed_flush(match_server_t* server, connection_t* conn) {
+    if (conn->tx_inflight > 0) return 0;
+    feed_advance(conn, 0);
+
+    while (conn->feed_pos < server->feed_pos) {
+        int n = 0;
+        size_t len = 0;
+        size_t off = conn->feed_off;
+        for (feed_chunk_t* chunk = conn->feed_chunk; chunk != NULL && n < FEED_IOVS; chunk = chunk->next) {
+            conn->feed_iov[n++] = (struct iovec){.iov_base = chunk->data + off, .iov_len = chunk->len - off};
+            len += chunk->len - off;
+            off = 0;
+        }
+
+#ifdef HAVE_IO_URING
+        if (server->backend == BACKEND_URING) {
+            // The chunks stay put while the send is in flight: the cursor holds on to the first,
+            // and each holds on to the next
+            struct io_uring_sqe* sqe = uring_get_sqe(&server->ring);
+            if (sqe == NULL) return -1;
+            conn->feed_msg = (struct msghdr){.msg_iov = conn->feed_iov, .msg_iovlen = n};
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->fd = conn->fd;
+            sqe->addr = (unsigned long)&conn->feed_msg;
+            sqe->len = 1;
+            sqe->msg_flags = MSG_NOSIGNAL;
+            sqe->user_data = (unsigned long)conn | OP_SEND;
+            conn->tx_inflight = len;
+            conn->ops++;
+            return 0;
+        }
+#endif
+
+        server->syscalls++;
+        ssize_t rc = writev(conn->fd, conn->feed_iov, n);
+        if (rc > 0) {
+            feed_advance(conn, rc);
+        } else if (rc == -1 && errno == EINTR) {
+            continue;
+        } else if (rc == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return -1;
+        }
+    }
+
+    conn_arm(server, conn, conn->feed_pos < server->feed_pos);
+    return 0;
+}
+
+/**
+ * Write as much of a connection's pending output as the socket will take right now
+ *
+ * @param server The match server
+ * @param conn   The connection to flush
+ * @return 0 on success, -1 if the connection failed (the caller closes it)
+ */
+static int conn_flush(match_server_t* server, connection_t* conn) {
+    if (conn->spectator) return feed_flush(server, conn);
+
+#ifdef HAVE_IO_URING
+    if (server->backend == BACKEND_URING) {
+        // One send at a time; frames queued meanwhile go out when it completes
+        if (conn->tx_inflight > 0 || conn->tx_len == 0) return 0;
+        struct io_uring_sqe* sqe = uring_get_sqe(&server->ring);
+        if (sqe == NULL) return -1;
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = conn->fd;
+        sqe->addr = (unsigned long)conn->tx;
+        sqe->len = conn->tx_len;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = (unsigned long)conn | OP_SEND;
+        conn->tx_inflight = conn->tx_len;
+        conn->ops++;
+        return 0;
+    }
+#endif
+
+    size_t written = 0;
+    while (written < conn->tx_len) {
+        server->syscalls++;
+        ssize_t rc = write(conn->fd, conn->tx + written, conn->tx_len - written);
+        if (rc > 0) {
+            written += rc;
+        } else if (rc == -1 && errno == EINTR) {
+            continue;
+        } else if (rc == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return -1;
+        }
+    }
+
+    // Keep whatever didn't fit at the front of the buffer and wait for EPOLLOUT
+    memmove(conn->tx, conn->tx + written, conn->tx_len - written);
+    conn->tx_len -= written;
+    conn_arm(server, conn, conn->tx_len > 0);
+    return 0;
+}
+
+/**
+ * Queue encoded frames on a connection. They go out with everything else the connection gets
+ * during this pass of the event loop (see flush_dirty).
+ *
+ * @param server The match server
+ * @param conn   The connection to send on (NULL or closed connections are skipped)
+ * @param bytes  The encoded frames
+ * @param len    Number of bytes
+ */
+static void conn_queue(match_server_t* server, connection_t* conn, const uint8_t* bytes, size_t len) {
+    if (conn == NULL || conn->fd == -1) return;
+
+    // A client that lets a full buffer pile up isn't reading, so give up on it (once nothing
+    // else in this pass can be holding on to its match)
+    if (conn->tx_len + len > TX_BUFFER_SIZE) {
+        conn->overflow = true;
+    } else {
+        memcpy(conn->tx + conn->tx_len, bytes, len);
+        conn->tx_len += len;
+    }
+
+    if (!conn->dirty) {
+        conn->dirty = true;
+        conn->next_dirty = server->dirty;
+        server->dirty = conn;
+    }
+}
+
+/**
+ * Queue a frame on a connection
+ *
+ * @param server The match server
+ * @param conn   The connection to send on
+ * @param frame  The frame to send
+ */
+static void conn_send(match_server_t* server, connection_t* conn, const frame_t* frame) {
+    uint8_t bytes[FRAME_SIZE];
+    encode_frame(frame, bytes);
+    conn_queue(server, conn, bytes, FRAME_SIZE);
+}
+
+/**
+ * Queue a frame on every seat of a match but one. The frame is encoded once and copied.
+ *
+ * @param server The match server
+ * @param match  The match
+ * @param frame  The frame to send
+ * @param except Seat that doesn't get it
+ */
+static void match_broadcast(match_server_t* server, match_t* match, const frame_t* frame, int except) {
+    uint8_t bytes[FRAME_SIZE];
+    encode_frame(frame, bytes);
+    for (int seat = 0; seat < match->nseats; seat++) {
+        if (seat != except) conn_queue(server, match->seats[seat], bytes, FRAME_SIZE);
+    }
+}
+
+/**
+ * Write out everything queued during this pass of the event loop: one write (or send) per
+ * connection, however many frames it got
+ *
+ * @param server The match server
+ */
+static void flush_dirty(match_server_t* server) {
+    // Closing a connection can queue a QUIT for the rest of its match, which joins the list
+    while (server->dirty != NULL) {
+        connection_t* conn = server->dirty;
+        server->dirty = conn->next_dirty;
+        conn->dirty = false;
+        if (conn->fd == -1) continue;
+        if (conn->overflow || conn_flush(server, conn) == -1) conn_close(server, conn);
+    }
+}
+
+/**
+ * Put a spectator at the back of the queue for a write
+ *
+ * @param server The match server
+ * @param conn   The spectator
+ */
+static void feed_enqueue(match_server_t* server, connection_t* conn) {
+    if (conn->feed_queued) return;
+    conn->feed_queued = true;
+    conn->next_feed = NULL;
+    if (server->feed_queue == NULL) {
+        server->feed_queue = conn;
+    } else {
+        server->feed_queue_tail->next_feed = conn;
+    }
+    server->feed_queue_tail = conn;
+}
+
+/**
+ * Send spectators what the feed got since they last wrote, after every player has been flushed.
+ * At most FEED_SENDS_PER_PASS spectators write per pass; the rest keep their place in the queue,
+ * and the event loop comes straight back for them without waiting.
+ *
+ * @param server The match server
+ */
+static void flush_feed(match_server_t* server) {
+    if (server->feed_fresh) {
+        server->feed_fresh = false;
+        // Backwards, since dropping a spectator moves the last one into its place
+        for (size_t i = server->nspectators; i-- > 0;) {
+            connection_t* conn = server->spectators[i];
+            if (server->feed_pos - conn->feed_pos > FEED_MAX_LAG) {
+                server->spectators_dropped++;
+                conn_close(server, conn);
+            } else if (!conn->write_armed && conn->tx_inflight == 0) {
+                // Spectators still busy with an earlier write pick this up once it's done
+                feed_enqueue(server, conn);
+            }
+        }
+    }
+
+    for (int sends = 0; sends < FEED_SENDS_PER_PASS && server->feed_queue != NULL;) {
+        connection_t* conn = server->feed_queue;
+        server->feed_queue = conn->next_feed;
+        conn->feed_queued = false;
+        if (conn->fd == -1) continue;
+        sends++;
+        if (feed_flush(server, conn) == -1) conn_close(server, conn);
+    }
+}
+
+/**
+ * Find the seat that shoots after another one
+ *
+ * @param match The match, with at least one other seat still in it
+ * @param seat  The seat that just shot (it may be out by now)
+ * @return The next seat in order that is still in the match
+ */
+static int next_seat(const match_t* match, int seat) {
+    do {
+        seat = (seat + 1) % match->nseats;
+    } while (match->out[seat]);
+    return seat;
+}
+
+/**
+ * Add one of a match's public events to the feed, if it's the featured match
+ *
+ * @param server The match server
+ * @param match  The match
+ * @param frame  The event (a RESULT or a QUIT)
+ */
+static void match_publish(match_server_t* server, match_t* match, const frame_t* frame) {
+    if (match == server->featured) feed_append(server, frame);
+}
+
+/**
+ * Take a seat out of a running match, because its fleet is gone or its player left. The last
+ * seat left wins and the match is over. Otherwise a player leaving is announced with a QUIT and
+ * the turn order carries on without them: if they were the attacker the next seat shoots, and
+ * if they were being shot at the attacker shoots again at somebody else.
+ *
+ * @param server The match server
+ * @param match  The match
+ * @param seat   The seat
+ * @param left   true if the player quit or hung up, false if their last ship sank
+ */
+static void match_eliminate(match_server_t* server, match_t* match, int seat, bool left) {
+    match->out[seat] = true;
+    match->alive--;
+
+    if (left) {
+        frame_t quit = {.type = MSG_QUIT, .seat = seat, .ship = NO_SHIP};
+        match_broadcast(server, match, &quit, seat);
+        match_publish(server, match, &quit);
+    }
+    if (match->alive <= 1) {
+        // The spectators move on to the next match to start
+        match->state = MATCH_OVER;
+        if (match == server->featured) server->featured = NULL;
+        return;
+    }
+    if (!left) return;
+
+    if (seat == match->attacker) {
+        // The defender may already be answering the shot: its result still counts (see match_stale_result)
+        if (match->state == MATCH_RESULT) {
+            match->stale = match->defender;
+            match->stale_attacker = seat;
+        }
+        match->attacker = next_seat(match, seat);
+        match->state = MATCH_ATTACK;
+    } else if (match->state == MATCH_RESULT && seat == match->defender) {
+        match->state = MATCH_ATTACK;
+    }
+}
+
+/**
+ * Apply the answer to an attack whose attacker left before it came back. The shot has landed on
+ * the defender's board, so everybody else but the attacker who left hears how it went, and a
+ * sunk ship counts, but the turn order (which moved on when the attacker left) stays put. If that
+ * was the defender's last ship and another attack on it is already waiting for an answer, that
+ * attack is called off and its attacker goes again, as if the defender had left.
+ *
+ * @param server The match server
+ * @param match  The match
+ * @param frame  The RESULT, from seat match->stale
+ */
+static void match_stale_result(match_server_t* server, match_t* match, const frame_t* frame) {
+    int defender = match->stale;
+    match->stale = -1;
+    // An answer to an attack that was called off, on a fleet that's already gone
+    if (match->state == MATCH_OVER || match->out[defender]) return;
+
+    frame_t forward = *frame;
+    forward.seat = match->stale_attacker;
+    forward.target = defender;
+    uint8_t bytes[FRAME_SIZE];
+    encode_frame(&forward, bytes);
+    for (int seat = 0; seat < match->nseats; seat++) {
+        if (seat != defender && seat != forward.seat) conn_queue(server, match->seats[seat], bytes, FRAME_SIZE);
+    }
+    match_publish(server, match, &forward);
+    if (frame->outcome != RESULT_SUNK || ++match->sunk[defender] < NDIFSHIPS) return;
+
+    bool called_off = match->state == MATCH_RESULT && match->defender == defender;
+    match_eliminate(server, match, defender, false);
+    if (match->state == MATCH_OVER) {
+        server->finished_matches++;
+    } else if (called_off) {
+        match->state = MATCH_ATTACK;
+        match->stale = defender;
+    }
+}
+
+/**
+ * Put a match in front of the spectators: the feed carries on from its WATCH frame, which is
+ * where anybody who starts watching during the match starts reading
+ *
+ * @param server The match server
+ * @param match  The match, just started
+ */
+static void match_feature(match_server_t* server, match_t* match) {
+    frame_t watch = {.type = MSG_WATCH, .target = match->nseats, .ship = NO_SHIP};
+    if (feed_append(server, &watch) == -1) return;
+
+    feed_chunk_t* start = server->feed_tail;
+    start->refs++;
+    feed_release(server->feed_start);
+    server->feed_start = start;
+    server->feed_start_off = start->len - FRAME_SIZE;
+    server->feed_start_pos = server->feed_pos - FRAME_SIZE;
+    server->featured = match;
+}
+
+/**
+ * Start the turn loop of a match once every seat is taken. Each player is told their seat and
+ * how many seats there are; seat 0 shoots first.
+ *
+ * @param server The match server
+ * @param match  The match to start
+ */
+static void match_start(match_server_t* server, match_t* match) {
+    match->state = MATCH_ATTACK;
+    match->attacker = 0;
+    for (int seat = 0; seat < match->nseats; seat++) {
+        frame_t ready = {.type = MSG_READY, .seat = seat, .target = match->nseats, .ship = NO_SHIP};
+        conn_send(server, match->seats[seat], &ready);
+    }
+    if (server->featured == NULL) match_feature(server, match);
+}
+
+/**
+ * Seat a player that is ready in the match that is filling up, starting a new one if there
+ * isn't any
+ *
+ * @param server The match server
+ * @param conn   The connection that sent READY
+ */
+static void match_pair(match_server_t* server, connection_t* conn) {
+    match_t* match = server->forming;
+    if (match == NULL) {
+        match = calloc(1, sizeof(match_t));
+        if (match == NULL) {
+            conn_close(server, conn);
+            return;
+        }
+        match->state = MATCH_PLACING;
+        match->stale = -1;
+        server->forming = match;
+    }
+
+    conn->match = match;
+    conn->seat = match->nseats;
+    match->seats[match->nseats++] = conn;
+    if (match->nseats < server->players) return;
+
+    // Every seat is taken
+    server->forming = NULL;
+    match->alive = match->nseats;
+    server->open_matches++;
+    match_start(server, match);
+}
+
+/**
+ * Turn a connection into a spectator of the featured match. It reads the feed from that match's
+ * WATCH frame, or, between matches, from the WATCH of the next one to start.
+ *
+ * @param server The match server
+ * @param conn   The connection that sent WATCH
+ */
+static void spectator_attach(match_server_t* server, connection_t* conn) {
+    if (server->nspectators == server->spectator_capacity) {
+        size_t capacity = server->spectator_capacity == 0 ? 64 : server->spectator_capacity * 2;
+        connection_t** grown = realloc(server->spectators, capacity * sizeof(connection_t*));
+        if (grown == NULL) {
+            conn_close(server, conn);
+            return;
+        }
+        server->spectators = grown;
+        server->spectator_capacity = capacity;
+    }
+    // A backlog waits in the shared feed rather than in a big kernel buffer for every spectator
+    int size = FEED_SOCKET_BUFFER;
+    server->syscalls++;
+    setsockopt(conn->fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+
+    conn->spectator = true;
+    conn->spectator_index = server->nspectators;
+    server->spectators[server->nspectators++] = conn;
+    server->spectators_watched++;
+
+    if (server->featured != NULL) {
+        conn->feed_chunk = server->feed_start;
+        conn->feed_off = server->feed_start_off;
+        conn->feed_pos = server->feed_start_pos;
+    } else {
+        conn->feed_chunk = server->feed_tail;
+        conn->feed_off = server->feed_tail->len;
+        conn->feed_pos = server->feed_pos;
+    }
+    conn->feed_chunk->refs++;
+    feed_enqueue(server, conn);
+}
+
+/**
+ * Stop feeding a closed spectator. Its cursor lets go of the feed once the connection is freed,
+ * when no io_uring send can still be reading the chunks.
+ *
+ * @param server The match server
+ * @param conn   The spectator
+ */
+static void spectator_detach(match_server_t* server, connection_t* conn) {
+    connection_t* last = server->spectators[--server->nspectators];
+    server->spectators[conn->spectator_index] = last;
+    last->spectator_index = conn->spectator_index;
+}
+
+/**
+ * Advance a connection's match with one decoded frame from that connection
+ *
+ * @param server The match server
+ * @param conn   The connection the frame arrived on
+ * @param frame  The frame
+ */
+static void handle_frame(match_server_t* server, connection_t* conn, const frame_t* frame) {
+    match_t* match = conn->match;
+
+    // A new connection says what it is: READY takes a seat, WATCH joins the spectators (who
+    // have nothing more to say)
+    if (match == NULL && !conn->spectator) {
+        if (frame->type == MSG_READY) {
+            match_pair(server, conn);
+        } else if (frame->type == MSG_WATCH) {
+            spectator_attach(server, conn);
+        } else {
+            conn_close(server, conn);
+        }
+        return;
+    }
+
+    if (match == NULL || match == server->forming) {
+        conn_close(server, conn);
+        return;
+    }
+
+    // The answer to an attack whose attacker left mid-shot
+    if (frame->type == MSG_RESULT && conn->seat == match->stale) {
+        match_stale_result(server, match, frame);
+        return;
+    }
+
+    // Stamp the seats ourselves rather than trusting the client's idea of them. With two seats
+    // the target is always the other one.
+    int attacker = match->attacker;
+    int defender = match->nseats == 2 ? 1 - attacker : frame->target;
+    if (match->state == MATCH_RESULT) defender = match->defender;
+
+    // An attack on a player who is out crossed paths with their QUIT, or with the late result that
+    // sank their last ship (see match_stale_result); the attacker goes again once it sees that
+    if (match->state == MATCH_ATTACK && conn->seat == attacker && frame->type == MSG_ATTACK &&
+        defender < match->nseats && match->out[defender]) {
+        return;
+    }
+    frame_t forward = *frame;
+    forward.seat = attacker;
+    forward.target = defender;
+
+    if (frame->type == MSG_QUIT) {
+        // Let everybody else know; the match ends once the players hang up, unless enough are left
+        if (match->state != MATCH_OVER && !match->out[conn->seat]) {
+            match_eliminate(server, match, conn->seat, true);
+        }
+    } else if (match->state == MATCH_ATTACK && conn->seat == attacker && frame->type == MSG_ATTACK &&
+               defender < match->nseats && defender != attacker && !match->out[defender]) {
+        // Only the target hears about the attack
+        match->state = MATCH_RESULT;
+        match->defender = defender;
+        server->turns++;
+        conn_send(server, match->seats[defender], &forward);
+    } else if (match->state == MATCH_RESULT && conn->seat == defender && frame->type == MSG_RESULT) {
+        // Everybody else hears how it went, then the next seat still in the match shoots
+        match_broadcast(server, match, &forward, defender);
+        match_publish(server, match, &forward);
+        if (frame->outcome == RESULT_SUNK && ++match->sunk[defender] == NDIFSHIPS) {
+            match_eliminate(server, match, defender, false);
+        }
+        if (match->state == MATCH_OVER) {
+            server->finished_matches++;
+        } else {
+            match->state = MATCH_ATTACK;
+            match->attacker = next_seat(match, attacker);
+        }
+    } else {
+        // Out of turn or after the match ended: drop the match
+        conn_close(server, conn);
+    }
+}
+
+/**
+ * Handle every complete frame in a connection's receive buffer. A partial frame stays buffered
+ * until the rest of it arrives.
+ *
+ * @param server The match server
+ * @param conn   The connection
+ */
+static void conn_process(match_server_t* server, connection_t* conn) {
+    const uint8_t* data;
+    while (conn->fd != -1 && (data = msg_conn_take(&conn->rx, FRAME_SIZE)) != NULL) {
+        frame_t frame;
+        if (decode_frame(data, &frame) == -1) {
+            conn_close(server, conn);
+            return;
+        }
+        handle_frame(server, conn, &frame);
+    }
+}
+
+/**
+ * Read everything available on a connection and handle each complete frame
+ *
+ * @param server The match server
+ * @param conn   The readable connection
+ */
+static void conn_read(match_server_t* server, connection_t* conn) {
+    while (conn->fd != -1) {
+        server->syscalls++;
+        ssize_t rc = msg_conn_fill(&conn->rx);
+        if (rc == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (rc <= 0) {
+            // The client hung up (or the socket failed)
+            conn_close(server, conn);
+            return;
+        }
+        conn_process(server, conn);
+    }
+}
+
+/**
+ * Close a connection. A player leaving a running match with at least two others still in it is
+ * taken out and the rest play on; otherwise the whole match is closed. The memory is released
+ * once the current batch of events is done and no io_uring request refers to it any more.
+ *
+ * @param server The match server
+ * @param conn   The connection to close
+ */
+static void conn_close(match_server_t* server, connection_t* conn) {
+    if (conn->fd == -1) return;
+
+    // Whatever is still queued (like the result that ended the match) goes out first
+    if (!conn->overflow) conn_flush(server, conn);
+
+    if (server->backend == BACKEND_EPOLL) {
+        server->syscalls++;
+        epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    } else {
+#ifdef HAVE_IO_URING
+        // Queued sends only name the fd number, which the next accept can hand out again as soon
+        // as it's closed, so push them to the kernel (which takes its own reference) first
+        if (uring_submit_and_wait(&server->ring, 0) > 0) server->syscalls++;
+#endif
+
+        // In-flight requests hold their own reference to the socket, so a plain close would
+        // leave the multishot recv armed. Shutting down ends it with a final completion.
+        server->syscalls++;
+        shutdown(conn->fd, SHUT_RDWR);
+    }
+    server->syscalls++;
+    close(conn->fd);
+    conn->fd = -1;
+#ifdef HAVE_IO_URING
+    // That freed a descriptor, so a paused accept can try again
+    if (server->accept_paused && !stop_requested && uring_arm_accept(server) == 0) server->accept_paused = false;
+#endif
+    conn->next_closed = server->closed;
+    server->closed = conn;
+    server->open_connections--;
+
+    if (conn->spectator) {
+        spectator_detach(server, conn);
+        return;
+    }
+
+    match_t* match = conn->match;
+    if (match == NULL) return;
+    conn->match = NULL;
+
+    // Nobody in a match that is still filling up knows their seat yet, so the newest player
+    // takes over the empty one
+    if (match == server->forming) {
+        connection_t* last = match->seats[--match->nseats];
+        match->seats[conn->seat] = last;
+        last->seat = conn->seat;
+        if (match->nseats == 0) {
+            free(match);
+            server->forming = NULL;
+        }
+        return;
+    }
+
+    match->seats[conn->seat] = NULL;
+    bool running = match->state == MATCH_ATTACK || match->state == MATCH_RESULT;
+    if (running && !match->out[conn->seat]) match_eliminate(server, match, conn->seat, true);
+    if (match->state == MATCH_ATTACK || match->state == MATCH_RESULT) return;
+
+    // Hang up on everybody else as well; their clients treat it like a dropped connection
+    connection_t* rest[MAX_SEATS];
+    int nrest = 0;
+    for (int seat = 0; seat < match->nseats; seat++) {
+        if (match->seats[seat] == NULL) continue;
+        match->seats[seat]->match = NULL;
+        rest[nrest++] = match->seats[seat];
+    }
+    if (match == server->featured) server->featured = NULL;
+    free(match);
+    server->open_matches--;
+    for (int i = 0; i < nrest; i++) {
+        conn_close(server, rest[i]);
+    }
+}
+
+/**
+ * Free closed connections that nothing refers to any more
+ *
+ * @param server The match server
+ */
+static void free_closed(match_server_t* server) {
+    connection_t** link = &server->closed;
+    while (*link != NULL) {
+        connection_t* conn = *link;
+        if (conn->ops > 0 || conn->feed_queued) {
+            link = &conn->next_closed;
+        } else {
+            *link = conn->next_closed;
+            if (conn->feed_chunk != NULL) feed_release(conn->feed_chunk);
+            free(conn);
+        }
+    }
+}
+
+/**
+ * Set up a newly accepted socket. Its first frame decides whether it plays or watches.
+ *
+ * @param server The match server
+ * @param fd     The accepted socket
+ * @return The connection, or NULL if it couldn't be set up (the socket is closed)
+ */
+static connection_t* conn_open(match_server_t* server, int fd) {
+    // Turns are tiny messages, so don't let Nagle hold them back
+    int opt = 1;
+    server->syscalls++;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+    connection_t* conn = calloc(1, sizeof(connection_t));
+    if (conn == NULL) {
+        close(fd);
+        return NULL;
+    }
+    conn->fd = fd;
+    msg_conn_init(&conn->rx, fd);
+    server->open_connections++;
+    return conn;
+}
+
+/**
+ * Accept every pending connection on the listening socket (epoll backend)
+ *
+ * @param server The match server
+ */
+static void accept_connections(match_server_t* server) {
+    while (true) {
+        server->syscalls++;
+        int fd = server_socket_accept(server->listen_fd);
+        if (fd == -1) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("Failed to accept client connection");
+            return;
+        }
+
+        server->syscalls += 2;
+        if (set_nonblocking(fd) == -1) {
+            close(fd);
+            continue;
+        }
+        connection_t* conn = conn_open(server, fd);
+        if (conn == NULL) continue;
+
+        server->syscalls++;
+        struct epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP, .data.ptr = conn};
+        if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) conn_close(server, conn);
+    }
+}
+
+/**
+ * Run the epoll event loop until a stop is requested
+ *
+ * @param server The match server
+ */
+static void run_epoll(match_server_t* server) {
+    // Register the listening socket. A NULL data pointer marks it.
+    server->epoll_fd = epoll_create1(0);
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = NULL};
+    if (server->epoll_fd == -1 || epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &ev) == -1) {
+        perror("Failed to set up epoll");
+        return;
+    }
+
+    struct epoll_event events[MAX_EVENTS];
+    while (!stop_requested) {
+        server->syscalls++;
+        // Don't block while spectators are still waiting for their turn to write
+        int n = epoll_wait(server->epoll_fd, events, MAX_EVENTS, server->feed_queue != NULL ? 0 : -1);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait failed");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            connection_t* conn = events[i].data.ptr;
+            if (conn == NULL) {
+                accept_connections(server);
+                continue;
+            }
+
+            // Read first so data sent right before a hangup is still handled
+            if (conn->fd != -1 && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+                conn_read(server, conn);
+            }
+            if (conn->fd != -1 && (events[i].events & EPOLLOUT) && conn_flush(server, conn) == -1) {
+                conn_close(server, conn);
+            }
+        }
+
+        // Now nothing in this batch can refer to the closed connections
+        flush_dirty(server);
+        flush_feed(server);
+        free_closed(server);
+    }
+
+    close(server->epoll_fd);
+}
+
+#ifdef HAVE_IO_URING
+
+/**
+ * Queue a multishot recv that fills provided buffers for as long as the connection is open
+ *
+ * @param server The match server
+ * @param conn   The connection to receive on
+ * @return 0 on success, -1 if the submission queue is full
+ */
+static int uring_arm_recv(match_server_t* server, connection_t* conn) {
+    struct io_uring_sqe* sqe = uring_get_sqe(&server->ring);
+    if (sqe == NULL) return -1;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BGID;
+    sqe->user_data = (unsigned long)conn | OP_RECV;
+    conn->ops++;
+    return 0;
+}
+
+/**
+ * Queue the listening socket's multishot accept
+ *
+ * @param server The match server
+ * @return 0 on success, -1 if the submission queue is full
+ */
+static int uring_arm_accept(match_server_t* server) {
+    struct io_uring_sqe* sqe = uring_get_sqe(&server->ring);
+    if (sqe == NULL) return -1;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = server->listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = ACCEPT_USER_DATA;
+    return 0;
+}
+
+/**
+ * Handle one io_uring completion
+ *
+ * @param server The match server
+ * @param cqe    The completion
+ */
+static void uring_complete(match_server_t* server, struct io_uring_cqe* cqe) {
+    bool more = cqe->flags & IORING_CQE_F_MORE;
+
+    // A new connection from the multishot accept
+    if (cqe->user_data == ACCEPT_USER_DATA) {
+        if (cqe->res >= 0) {
+            connection_t* conn = conn_open(server, cqe->res);
+            if (conn != NULL && uring_arm_recv(server, conn) == -1) conn_close(server, conn);
+        } else if (cqe->res != -EAGAIN && cqe->res != -EINTR && cqe->res != -ECONNABORTED) {
+            errno = -cqe->res;
+            perror("Failed to accept client connection");
+        }
+        if (more || stop_requested) return;
+
+        // Out of descriptors or memory a new accept would fail straight away, over and over, so
+        // wait until a connection closes and gives some back before accepting again
+        if (cqe->res == -EMFILE || cqe->res == -ENFILE || cqe->res == -ENOBUFS || cqe->res == -ENOMEM) {
+            server->accept_paused = true;
+        } else {
+            uring_arm_accept(server);
+        }
+        return;
+    }
+
+    connection_t* conn = (connection_t*)(unsigned long)(cqe->user_data & ~(unsigned long)OP_MASK);
+    int op = cqe->user_data & OP_MASK;
+
+    if (op == OP_SEND) {
+        conn->ops--;
+        conn->tx_inflight = 0;
+        if (conn->fd == -1) return;
+        if (cqe->res < 0) {
+            conn_close(server, conn);
+            return;
+        }
+        // Drop what was sent; anything queued behind it goes out next
+        if (conn->spectator) {
+            feed_advance(conn, cqe->res);
+        } else {
+            memmove(conn->tx, conn->tx + cqe->res, conn->tx_len - cqe->res);
+            conn->tx_len -= cqe->res;
+        }
+        if (conn_flush(server, conn) == -1) conn_close(server, conn);
+        return;
+    }
+
+    // OP_RECV: the multishot recv produced data, hit EOF, or stopped
+    if (!more) conn->ops--;
+    if (cqe->flags & IORING_CQE_F_BUFFER) {
+        unsigned short bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        if (cqe->res > 0 && conn->fd != -1 && msg_conn_push(&conn->rx, uring_buf(&server->buffers, bid), cqe->res) == -1) {
+            conn_close(server, conn);
+        }
+        uring_buf_recycle(&server->buffers, bid);
+    }
+    if (conn->fd == -1) return;
+
+    if (cqe->res == 0 || (cqe->res < 0 && cqe->res != -ENOBUFS)) {
+        // The client hung up (or the socket failed)
+        conn_close(server, conn);
+        return;
+    }
+    conn_process(server, conn);
+
+    // The kernel ends a multishot recv when it runs out of buffers; start another one
+    if (!more && conn->fd != -1 && uring_arm_recv(server, conn) == -1) conn_close(server, conn);
+}
+
+/**
+ * Run the io_uring event loop until a stop is requested
+ *
+ * @param server The match server
+ */
+static void run_uring(match_server_t* server) {
+    if (uring_init(&server->ring, URING_ENTRIES, URING_CQ_ENTRIES) == -1) {
+        perror("Failed to set up io_uring");
+        return;
+    }
+    if (uring_buf_ring_init(&server->ring, &server->buffers, URING_BUFFERS, URING_BUFFER_SIZE, URING_BGID) == -1) {
+        perror("Failed to register io_uring receive buffers");
+        uring_exit(&server->ring);
+        return;
+    }
+    uring_arm_accept(server);
+
+    while (!stop_requested) {
+        // Submit everything the last pass queued and wait for at least one completion, unless
+        // spectators are still waiting for their turn to write
+        if (uring_submit_and_wait(&server->ring, server->feed_queue != NULL ? 0 : 1) == -1 && errno != EINTR) {
+            perror("io_uring_enter failed");
+            break;
+        }
+
+        struct io_uring_cqe* cqe;
+        while ((cqe = uring_peek_cqe(&server->ring)) != NULL) {
+            uring_complete(server, cqe);
+            uring_cqe_seen(&server->ring);
+        }
+
+        // The sends this pass produced go out with the next io_uring_enter
+        flush_dirty(server);
+        flush_feed(server);
+        free_closed(server);
+    }
+
+    server->syscalls += server->ring.enters;
+    uring_exit(&server->ring);
+}
+
+#endif
+
+/**
+ * Stop the event loop at the next wakeup
+ *
+ * @param signum The signal received
+ */
+static void request_stop(int signum) {
+    stop_requested = true;
+}
+
+/**
+ * Listen on the given port and host matches until interrupted, then print statistics.
+ *
+ * @param port    The port number to listen on (0 lets the OS pick one)
+ * @param backend Which I/O backend drives the event loop
+ * @param players Seats per match, 2..MAX_SEATS
+ */
+void run_match_server(unsigned short port, server_backend_t backend, int players) {
+    match_server_t server = {0};
+    server.backend = backend;
+    server.players = players;
+
+    // The feed starts out as one empty chunk
+    server.feed_start = server.feed_tail = calloc(1, sizeof(feed_chunk_t));
+    if (server.feed_start == NULL) {
+        perror("Failed to allocate the spectator feed");
+        exit(EXIT_FAILURE);
+    }
+    server.feed_start->refs = 1;
+
+#ifndef HAVE_IO_URING
+    if (backend == BACKEND_URING) {
+        fprintf(stderr, "This build has no io_uring support.\n");
+        exit(EXIT_FAILURE);
+    }
+#endif
+
+    // A client that disappears mid-write must not kill every other match
+    signal(SIGPIPE, SIG_IGN);
+
+    // Stop cleanly on Ctrl-C so we can report what happened
+    struct sigaction sa = {.sa_handler = request_stop};
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    // Open the listening socket
+    server.listen_fd = server_socket_open(&port);
+    if (server.listen_fd == -1) {
+        perror("Failed to open server socket");
+        exit(EXIT_FAILURE);
+    }
+    if (listen(server.listen_fd, SOMAXCONN) == -1 || set_nonblocking(server.listen_fd) == -1) {
+        perror("Failed to listen on server socket");
+        close(server.listen_fd);
+        exit(EXIT_FAILURE);
+    }
+    printf("Hosting %d-player matches on port %u (%s)\n", players, port, backend == BACKEND_URING ? "io_uring" : "epoll");
+    fflush(stdout);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+#ifdef HAVE_IO_URING
+    if (backend == BACKEND_URING) {
+        run_uring(&server);
+    } else {
+        run_epoll(&server);
+    }
+#else
+    run_epoll(&server);
+#endif
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("\n%zu matches finished, %lu turns in %.2f s (%.0f turns/s)\n", server.finished_matches, server.turns,
+           seconds, seconds > 0 ? server.turns / seconds : 0);
+    printf("%lu syscalls (%.2f per turn)\n", server.syscalls,
+           server.turns > 0 ? (double)server.syscalls / server.turns : 0);
+    if (server.spectators_watched > 0) {
+        printf("%lu spectators, %lu dropped for falling behind\n", server.spectators_watched,
+               server.spectators_dropped);
+    }
+
+    close(server.listen_fd);
+}
+
+#else
+
+/**
+ * Listen on the given port and host matches until interrupted, then print statistics.
+ *
+ * @param port    The port number to listen on (0 lets the OS pick one)
+ * @param backend Which I/O backend drives the event loop
+ * @param players Seats per match, 2..MAX_SEATS
+ */
+void run_match_server(unsigned short port, server_backend_t backend, int players) {
+    fprintf(stderr, "Hosting matches needs epoll, which is only available on Linux.\n");
+    exit(EXIT_FAILURE);
+}
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * Match host: one process, one event loop, many concurrent games.
+ *
+ * Clients connect with "./battleship client <host> <port>" exactly like they would against
+ * "./battleship server". The host seats players in the order their fleets are ready into matches
+ * of two or more and relays each match's messages between them: an attack goes to the seat it
+ * names, and its result to everybody else. Every match is a small state machine driven by
+ * non-blocking socket events, so thousands of games share a single thread.
+ *
+ * "./battleship watch <host> <port>" connects as a spectator instead, and follows one featured
+ * match after another: every shot, hit, miss, sunk ship, and player leaving.
+ */
+
+#pragma once
+
+//how the host moves bytes between sockets
+typedef enum server_backend {
+    BACKEND_EPOLL,  // readiness events plus read/write syscalls
+    BACKEND_URING   // io_uring: multishot accept/recv and batched sends (Linux 6.0+)
+} server_backend_t;
+
+/**
+ * Listen on the given port and host matches until interrupted (Ctrl-C), then print how many
+ * turns were relayed and how many syscalls it took.
+ *
+ * @param port    The port number to listen on (0 lets the OS pick one)
+ * @param backend Which I/O backend drives the event loop
+ * @param players Seats per match, 2..MAX_SEATS (see protocol.h)
+ */
+void run_match_server(unsigned short port, server_backend_t backend, int players);
@@ -0,0 +1,252 @@
+#include "montecarlo.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "placement.h"
+
+#define MC_BATCH 64 // fleets a worker draws between looks at the clock
+
+/**
+ * mc_job struct, stores one move's sampling problem, read-only while the workers run
+ */
+typedef struct mc_job {
+    const placement_t* candidates[NDIFSHIPS][MAX_PLACEMENTS];   // positions each unpinned ship could be in
+    int count[NDIFSHIPS];
+    int order[NDIFSHIPS];       // the unpinned ships, fewest candidates first
+    int ships;                  // number of unpinned ships
+    bitboard_t fixed;           // cells of the pinned-down sunk ships
+    bitboard_t hit;             // every hit, all of which a fleet must cover
+    bitboard_t unguessed;       // cells worth counting
+    uint64_t deadline_ns;
+} mc_job_t;
+
+/**
+ * mc_worker struct, stores one sampling thread and what it counted for the current move
+ */
+typedef struct mc_worker {
+    pthread_t thread;
+    mc_pool_t* pool;
+    rng_t rng;
+    unsigned long kept;             // consistent fleets drawn this move
+    uint32_t counts[BB_CELLS];      // how many of them had a ship on each cell
+} __attribute__((aligned(64))) mc_worker_t;
+
+struct mc_pool {
+    pthread_mutex_t mutex;
+    pthread_cond_t start;       // a new move is ready (or the pool is shutting down)
+    pthread_cond_t done;        // the last worker finished the move
+    uint64_t generation;        // bumped for every move
+    int running;                // workers still sampling the current move
+    bool shutdown;
+    int nworkers;
+    mc_worker_t* workers;
+    mc_job_t job;
+};
+
+/**
+ * Read the monotonic clock
+ *
+ * @return The time in nanoseconds
+ */
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Draw fleets until the job's deadline, counting the consistent ones
+ *
+ * @param worker The worker
+ * @param job    The move to sample
+ */
+static void sample(mc_worker_t* worker, const mc_job_t* job) {
+    worker->kept = 0;
+    for (int i = 0; i < BB_CELLS; i++) worker->counts[i] = 0;
+
+    do {
+        for (int n = 0; n < MC_BATCH; n++) {
+            // Draw each ship from its candidates, giving up on the fleet at the first overlap
+            bitboard_t occupied = job->fixed;
+            bool overlap = false;
+            for (int s = 0; s < job->ships && !overlap; s++) {
+                int ship = job->order[s];
+                const placement_t* placement = job->candidates[ship][rng_below(&worker->rng, job->count[ship])];
+                overlap = !bb_empty(bb_and(placement->mask, occupied));
+                occupied = bb_or(occupied, placement->mask);
+            }
+            if (overlap || !bb_empty(bb_andnot(job->hit, occupied))) continue;
+
+            worker->kept++;
+            bitboard_t cells = bb_and(occupied, job->unguessed);
+            for (int w = 0; w < BB_WORDS; w++) {
+                for (uint64_t bits = cells.w[w]; bits != 0; bits &= bits - 1) {
+                    worker->counts[w * 64 + __builtin_ctzll(bits)]++;
+                }
+            }
+        }
+    } while (now_ns() < job->deadline_ns);
+}
+
+/**
+ * A worker thread: wait for a move, sample it, report back, repeat
+ */
+static void* worker_main(void* arg) {
+    mc_worker_t* worker = arg;
+    mc_pool_t* pool = worker->pool;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (true) {
+        while (pool->generation == seen && !pool->shutdown) pthread_cond_wait(&pool->start, &pool->mutex);
+        if (pool->shutdown) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        sample(worker, &pool->job);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->running == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+// Start a pool of sampling threads
+mc_pool_t* mc_pool_create(int threads, uint64_t seed) {
+    if (threads < 1) threads = 1;
+    mc_pool_t* pool = calloc(1, sizeof(mc_pool_t));
+    if (pool == NULL) return NULL;
+    if (posix_memalign((void**)&pool->workers, 64, threads * sizeof(mc_worker_t)) != 0) {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        mc_worker_t* worker = &pool->workers[i];
+        worker->pool = pool;
+        rng_seed(&worker->rng, seed + i);
+        if (pthread_create(&worker->thread, NULL, worker_main, worker) != 0) break;
+        pool->nworkers++;
+    }
+    if (pool->nworkers == 0) {
+        mc_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+// Stop the pool's threads and free it
+void mc_pool_destroy(mc_pool_t* pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+    for (int i = 0; i < pool->nworkers; i++) pthread_join(pool->workers[i].thread, NULL);
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->workers);
+    free(pool);
+}
+
+/**
+ * Set up a move's job: list the positions each unpinned ship could be in, given what the AI knows
+ *
+ * @param job The job to fill in
+ * @param ai  What the AI knows
+ * @return true if every ship has at least one position (false means the history is inconsistent)
+ */
+static bool make_job(mc_job_t* job, const ai_t* ai) {
+    bitboard_t misses = bb_andnot(ai->guessed, ai->hit);
+    bitboard_t open = bb_andnot(ai->hit, ai->sunk);
+    job->fixed = ai->sunk;
+    job->hit = ai->hit;
+    job->unguessed = bb_andnot(bb_all(), ai->guessed);
+    job->ships = 0;
+
+    for (int i = 0; i < NDIFSHIPS; i++) {
+        if (ai->pinned[i]) continue;
+        const placementTable_t* table = placements_for_ship(i);
+        bool sunk = ai->sunkAt[i] != NO_SHIP_INDEX;
+
+        int s = job->ships++;
+        job->order[s] = s;
+        job->count[s] = 0;
+        for (int p = 0; p < table->count; p++) {
+            const placement_t* placement = &table->placements[p];
+            bool fits;
+            if (sunk) {
+                // A sunk ship lies on unclaimed hits, through the shot that sank it
+                int at = ai->sunkAt[i];
+                fits = bb_empty(bb_andnot(placement->mask, open)) &&
+                       ((placement->mask.w[at / 64] >> (at % 64)) & 1);
+            } else {
+                // An afloat ship avoids misses and sunk ships, and isn't hit all over
+                fits = bb_empty(bb_and(placement->mask, bb_or(misses, ai->sunk))) &&
+                       !bb_empty(bb_andnot(placement->mask, ai->hit));
+            }
+            if (fits) job->candidates[s][job->count[s]++] = placement;
+        }
+        if (job->count[s] == 0) return false;
+
+        // Keep the ships sorted by how constrained they are, so conflicts show up early
+        for (int t = s; t > 0 && job->count[job->order[t]] < job->count[job->order[t - 1]]; t--) {
+            job->order[t] = job->order[t - 1];
+            job->order[t - 1] = s;
+        }
+    }
+    return true;
+}
+
+// Pick the next cell to shoot at by sampling consistent fleets for a fixed time
+unsigned long mc_choose_shot(mc_pool_t* pool, ai_t* ai, uint64_t budget_ns, int* x, int* y) {
+    if (!make_job(&pool->job, ai)) {
+        ai_choose_shot(ai, x, y);
+        return 0;
+    }
+    pool->job.deadline_ns = now_ns() + budget_ns;
+
+    // Hand the move to every worker and wait for them all to run out of time
+    pthread_mutex_lock(&pool->mutex);
+    pool->running = pool->nworkers;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    while (pool->running > 0) pthread_cond_wait(&pool->done, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+
+    unsigned long kept = 0;
+    uint32_t counts[BB_CELLS] = {0};
+    for (int w = 0; w < pool->nworkers; w++) {
+        kept += pool->workers[w].kept;
+        for (int i = 0; i < BB_CELLS; i++) counts[i] += pool->workers[w].counts[i];
+    }
+    if (kept == 0) {
+        ai_choose_shot(ai, x, y);
+        return 0;
+    }
+
+    // Shoot at the unguessed cell that held a ship most often (ties broken at random)
+    uint32_t best = 0;
+    bitboard_t choices = {{0}};
+    for (int i = 0; i < BB_CELLS; i++) {
+        int cx = i % NCOLS + 1, cy = i / NCOLS + 1;
+        if (bb_test(&ai->guessed, cx, cy)) continue;
+        if (counts[i] > best || bb_empty(choices)) {
+            best = counts[i];
+            choices = (bitboard_t){{0}};
+        }
+        if (counts[i] == best) bb_set(&choices, cx, cy);
+    }
+    int cell = bb_select(choices, rng_below(&ai->rng, bb_count(choices)));
+    *x = cell % NCOLS + 1;
+    *y = cell / NCOLS + 1;
+    return kept;
+}
@@ -0,0 +1,55 @@
+/**
+ * Monte Carlo computer player - a stronger, slower alternative to the heatmap in ai.h.
+ *
+ * For each shot a pool of worker threads draws whole enemy fleets at random, keeping only the
+ * ones that agree with everything seen so far: no ship on a miss, every hit covered, each sunk
+ * ship lying on hits through the shot that sank it, and no afloat ship fully hit. Each worker
+ * counts how often every unguessed cell holds a ship in the fleets it kept; the counts are added up
+ * when the move's time budget runs out and the AI shoots at the cell that held a ship most often.
+ * Every ship is drawn uniformly from the positions that fit what is known about it and the whole
+ * fleet is thrown away on any conflict, so the kept fleets are a uniform sample of the consistent
+ * ones. More cores or a longer budget mean more samples and a better estimate.
+ *
+ * The AI's knowledge (hits, misses, sunk ships) is the same ai_t the heatmap player uses, so the
+ * two can be swapped between moves, and the heatmap takes over for a move if no consistent fleet
+ * turns up in time.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "ai.h"
+
+/**
+ * mc_pool struct, stores the worker threads and the move they're sampling (see montecarlo.c)
+ */
+typedef struct mc_pool mc_pool_t;
+
+/**
+ * Start a pool of sampling threads
+ *
+ * @param threads Number of worker threads (at least 1)
+ * @param seed    Seed for the workers' random numbers
+ * @return The pool, or NULL if it couldn't be created
+ */
+mc_pool_t* mc_pool_create(int threads, uint64_t seed);
+
+/**
+ * Stop the pool's threads and free it
+ *
+ * @param pool The pool
+ */
+void mc_pool_destroy(mc_pool_t* pool);
+
+/**
+ * Pick the next cell to shoot at by sampling consistent fleets for a fixed time
+ *
+ * @param pool      The pool
+ * @param ai        What the AI knows about the opponent's board (update it with ai_record_shot)
+ * @param budget_ns How long to sample for, in nanoseconds
+ * @param x         Set to the column, 1..NCOLS
+ * @param y         Set to the row, 1..NROWS
+ * @return The number of consistent fleets the choice is based on (0 if the heatmap chose instead)
+ */
+unsigned long mc_choose_shot(mc_pool_t* pool, ai_t* ai, uint64_t budget_ns, int* x, int* y);
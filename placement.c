@@ -0,0 +1,101 @@
+#include "placement.h"
+
+#define PLACEMENT_TRIES 1000    // random positions tried per ship before starting the fleet over
+
+//every legal position of a ship of each size, built by build_placements as the program loads
+static placementTable_t tables[MAX_SHIP_SIZE + 1];
+
+/**
+ * Work out every legal position of a ship of every size. Runs before main (or when the shared
+ * library is loaded), so the tables are ready before any thread can look at them.
+ */
+__attribute__((constructor)) static void build_placements() {
+    for (int size = 1; size <= MAX_SHIP_SIZE; size++) {
+        placementTable_t* table = &tables[size];
+        for (int i = 0; i < BB_CELLS; i++) {
+            table->index[HORIZONTAL][i] = table->index[VERTICAL][i] = NO_PLACEMENT;
+        }
+
+        for (int y = 1; y <= NROWS; y++) {
+            for (int x = 1; x <= NCOLS; x++) {
+                for (int orientation = HORIZONTAL; orientation <= VERTICAL; orientation++) {
+                    bool vertical = orientation == VERTICAL;
+                    // A ship of size 1 looks the same both ways, so it only gets one entry
+                    if (vertical && (size == 1 || y + size - 1 > NROWS)) continue;
+                    if (!vertical && x + size - 1 > NCOLS) continue;
+
+                    placement_t* placement = &table->placements[table->count];
+                    placement->mask = bb_line(x, y, size, vertical);
+                    placement->size = size;
+                    placement->startx = x;
+                    placement->starty = y;
+                    placement->orientation = orientation;
+                    for (int c = 0; c < size; c++) {
+                        placement->cells[c] = vertical ? bb_index(x, y + c) : bb_index(x + c, y);
+                    }
+                    table->index[orientation][bb_index(x, y)] = table->count++;
+                    bb_set(&table->starts[orientation], x, y);
+                }
+            }
+        }
+        if (size == 1) {
+            // ...but can still be asked for as vertical
+            for (int i = 0; i < BB_CELLS; i++) table->index[VERTICAL][i] = table->index[HORIZONTAL][i];
+        }
+    }
+}
+
+// Get the legal positions of a ship of one size
+const placementTable_t* placements_for_size(int size) {
+    return &tables[size];
+}
+
+// Get the legal positions of one of the ships in shipArray
+const placementTable_t* placements_for_ship(int ship) {
+    return placements_for_size(shipArray[ship].size);
+}
+
+// Look up the placement a proposal describes
+const placement_t* placement_find(struct shipLocation proposal) {
+    int size = proposal.shipType.size;
+    if (size < 1 || size > MAX_SHIP_SIZE) return NULL;
+    if (proposal.orientation != HORIZONTAL && proposal.orientation != VERTICAL) return NULL;
+    if (proposal.startx < 1 || proposal.startx > NCOLS || proposal.starty < 1 || proposal.starty > NROWS) {
+        return NULL;
+    }
+
+    const placementTable_t* table = placements_for_size(size);
+    int entry = table->index[proposal.orientation][bb_index(proposal.startx, proposal.starty)];
+    return entry == NO_PLACEMENT ? NULL : &table->placements[entry];
+}
+
+// Put a ship on a board at a placement that fits
+void board_place(board_t* board, int index, const placement_t* placement) {
+    fleetShip_t* ship = &board->fleet[index];
+    ship->cells = placement->mask;
+    ship->hitPoints = placement->size;
+    ship->sunk = false;
+    board->occupied = bb_or(board->occupied, placement->mask);
+    board->shipsPlaced++;
+}
+
+// Place a whole random fleet on a board
+void board_random_fleet(board_t* board, rng_t* rng) {
+    // The ships placed first can leave no room for a later one, so start over when that happens
+    while (true) {
+        initBoard(board);
+        int i;
+        for (i = 0; i < NDIFSHIPS; i++) {
+            // Pick legal positions at random until one misses every ship placed so far
+            const placementTable_t* table = placements_for_ship(i);
+            const placement_t* placement = NULL;
+            for (int tries = 0; tries < PLACEMENT_TRIES && placement == NULL; tries++) {
+                placement = &table->placements[rng_below(rng, table->count)];
+                if (!placement_fits(board, placement)) placement = NULL;
+            }
+            if (placement == NULL) break;
+            board_place(board, i, placement);
+        }
+        if (i == NDIFSHIPS) return;
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * Legal ship placements, worked out once. For every ship size there is a table of every position
+ * a ship of that size can take on the board, each stored as its bitboard mask plus the cells it
+ * covers, and an index from (orientation, start cell) to its entry. Validating a placement is then
+ * a table lookup and one AND against the board's occupied cells, and anything that needs to walk
+ * every possible position of a ship (fleet auto-placement, probability-density AIs, samplers)
+ * just iterates over a table instead of redoing the bounds and overlap geometry.
+ *
+ * The tables are built as the program (or libbattleship.so) loads, before main runs.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "board.h"
+#include "rng.h"
+
+#define MAX_SHIP_SIZE (NROWS > NCOLS ? NROWS : NCOLS)   // no ship can be longer than the board
+#define MAX_PLACEMENTS (2 * NROWS * NCOLS)              // a ship at most fits both ways at every cell
+#define NO_PLACEMENT -1                                 // index entry of a position off the board
+
+/**
+ * placement struct, stores one legal position of a ship
+ */
+typedef struct placement {
+    bitboard_t mask;                // cells the ship covers
+    uint8_t cells[MAX_SHIP_SIZE];   // their bit indexes, first to last (only size of them are used)
+    uint8_t size;
+    uint8_t startx;                 // column of the first cell, 1..NCOLS
+    uint8_t starty;                 // row of the first cell, 1..NROWS
+    uint8_t orientation;            // HORIZONTAL or VERTICAL
+} placement_t;
+
+/**
+ * placementTable struct, stores every legal position of a ship of one size
+ */
+typedef struct placementTable {
+    int count;
+    placement_t placements[MAX_PLACEMENTS];
+    int16_t index[2][BB_CELLS];     // [orientation][bit index of the first cell] -> entry, or NO_PLACEMENT
+    bitboard_t starts[2];           // [orientation] first cell of every entry, for whole-board bit math
+} placementTable_t;
+
+/**
+ * Get the legal positions of a ship of one size
+ *
+ * @param size The ship's size, 1..MAX_SHIP_SIZE
+ * @return The table
+ */
+const placementTable_t* placements_for_size(int size);
+
+/**
+ * Get the legal positions of one of the ships in shipArray
+ *
+ * @param ship Index of the ship in shipArray
+ * @return The table
+ */
+const placementTable_t* placements_for_ship(int ship);
+
+/**
+ * Look up the placement a proposal describes
+ *
+ * @param proposal The proposal
+ * @return The placement, or NULL if the ship would be off the board (or the orientation or size
+ *         is invalid)
+ */
+const placement_t* placement_find(struct shipLocation proposal);
+
+/**
+ * Check whether a placement is clear of every ship already on a board
+ *
+ * @param board     The board
+ * @param placement The placement
+ * @return true if none of its cells hold a ship
+ */
+static inline bool placement_fits(const board_t* board, const placement_t* placement) {
+    return bb_empty(bb_and(placement->mask, board->occupied));
+}
+
+/**
+ * Put a ship on a board at a placement that fits
+ *
+ * @param board     The board
+ * @param index     Index of the ship in shipArray
+ * @param placement Where to put it (from the ship's table)
+ */
+void board_place(board_t* board, int index, const placement_t* placement);
+
+/**
+ * Place a whole random fleet (every ship in shipArray) on a board. Every legal fleet can come
+ * out, and the same seed always gives the same fleet. If the ships placed first leave no room
+ * for a later one, the whole fleet is placed again.
+ *
+ * @param board The board (reset first)
+ * @param rng   Random state
+ */
+void board_random_fleet(board_t* board, rng_t* rng);
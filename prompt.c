@@ -0,0 +1,635 @@
+/**
+ * The curses side of the board: prompting the player to place ships and enter coordinates,
+ * reporting the opponent's guesses, and keeping the prompt window's cursor in bounds. The
+ * board itself is the headless engine in board.c.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <curses.h>
+#include <unistd.h>
+
+#include "prompt.h"
+#include "placement.h"
+#include "graphics.h"
+#include "render.h"
+
+//number of characters we read in at a time 
+#define BUFFERSIZE 4
+
+//prompt window whose cursor we keep in bounds (NULL when not tracking), and its height
+static WINDOW* tracked_prompt_win = NULL;
+static int tracked_prompt_rows;
+
+//track most recent prompt (not including error messages)
+char * most_recent_prompt;
+
+//track space
+int space;
+
+/**validOrt
+ *  validOrt takes the user input window 
+ *  validOrt instructs the user to give us an orientation (either "V" or "H") and loops until 
+ *  the user inputs a valid orientation. It then returns that valid orientation.
+ *  Since we handle user input here, the function is mostly error checking.
+ */
+enum Orientation validOrt(WINDOW * window){
+    
+    //set ORT to INVALID to control the while loop which will loop until we have a valid orientation
+    enum Orientation ORT = INVALID;
+    bool invalid = true;
+    
+    //save this value so that we can print to the correct horizontal cursor location
+    space = strlen("Please input orientation (V/H): ")+1;
+
+    //provide user instructions
+    render_print(window, cursor, 1, "Please input orientation (V/H): ");
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Please input orientation (V/H): ");
+
+    //loop until we have valid input
+    while (invalid){
+        
+        //store input
+        char orientation[2]; //2 because it's one character and a terminating character
+        orientation[1]='\0';
+        orientation[0]=prompt_getch();
+
+        //handle case where user input '/n'
+        if(orientation[0]=='\n'){
+            cursor++;
+            render_print(window, cursor++, 1, "Invalid orientation, try again. Please enter 'V' for vertical or 'H' \n");
+            render_print(window, cursor, 3, "for horizontal: \n");
+            space = strlen("for horizontal: \n")+3;
+            continue;
+        }
+
+        // save next character user entered, because there's at least one, even if it's a '\n'
+        char potentialNewline = prompt_getch();
+        bool newline = potentialNewline=='\n';
+
+        //clean up user input 
+        while(potentialNewline!='\n'){
+            potentialNewline=prompt_getch();
+        }
+
+        //print user input (at least the first character) so they can see what they entered
+        render_print(window, cursor++, space, "%s", orientation);
+
+        //if we have invalid input that was too long
+        if(!newline){
+            render_print(window, cursor++, 1, "Invalid orientation, try again. Please enter 'V' for vertical or 'H' \n");
+            render_print(window, cursor, 3, "for horizontal: \n");
+            space = strlen("for horizontal: \n")+3;
+        } else {
+            /**
+             * we were given one character of input, so check for valid input and, if valid, save it
+             * into ORT and flip invalid boolean, otherwise loop again with an informative message
+             */
+            if (orientation[0] == 'H'){
+                ORT = HORIZONTAL;
+                invalid = false;
+            } else if(orientation[0] == 'V') {
+                ORT = VERTICAL;
+                invalid = false;
+            } else {
+                render_print(window, cursor++, 1, "Invalid orientation, try again. Please enter 'V' for vertical or 'H' \n");
+                render_print(window, cursor, 3, "for horizontal: \n");
+                space = strlen("for horizontal: \n")+3;
+            }
+        }
+
+    }//while
+
+    //return ORT because it won't reach this line until it's valid
+    return ORT;
+
+}//validOrt
+
+
+
+/**validCoords
+ *  validCoords takes a pointer to an int array that it will fill with the two valid coordinate
+ *  values. It also takes the user input window since it deals with user input. Since this input
+ *  is more structured and complicated, most of this function is error checking.
+ */
+int * validCoords(int * yay, WINDOW * window, char * prompt){
+    most_recent_prompt = strdup(prompt);
+    //use this bool to control the while loop to loop until both coordinate values are valid
+    bool supa = true; //we used the word valid too much in this method so we picked supa as the bool name
+
+    //save horizontal indentation for cursor 
+    int space = strlen(prompt)+1;
+
+    //give user instructions
+    render_print(window, cursor, 1, "%s", prompt);
+
+    //loop until we have valid input
+    while (supa){
+
+        //store user input
+        char coords[BUFFERSIZE+1];
+
+        /**
+         * if we have a two-digit row (10 and up) as the input numeric value. This case is special because
+         * it's a diffent number of input characters, so we have to hand it specifically and carefully. This
+         * bool will only be flipped to true if the user input 1 and a second digit, and ones holds that digit.
+         */
+        bool ten = false;
+        int ones = 0;
+
+        //for use later in error checking;
+        bool shortInput = false;
+
+        //collect first (up to) three user input characters
+        for(int i = 0; i<BUFFERSIZE-1; i++){
+            coords[i]=(char) prompt_getch();
+            if(coords[i]=='\n') {
+                shortInput = true;
+                coords[i+1] = '\0';
+                break;
+            } else {
+                coords[BUFFERSIZE] = '\0';
+            }
+        }
+        
+        //print user input so they can see what they wrote
+        render_print(window, cursor, space, "%c%c%c", coords[0], coords[1], coords[2]);
+    
+        //check if input was too short or improperly formatted
+        bool noNewlines = ((coords[0]!='\n')&&(coords[1]!='\n')&&(coords[2]!='\n'));
+        bool comma = (coords[1]==',');
+
+        //ensure valid string length
+        if (strlen(coords) == 3 && noNewlines && comma){
+            
+            //get the next character - should either be a \n or a digit (in the case of 10 and up)
+            char next = (char) prompt_getch();
+
+            //check for a two-digit row
+            if(coords[2]=='1'){
+                
+                /**ensure that if it was 10 and up, it was input properly, and then print the second digit (and \n for
+                 * formatting) so the user can see the rest of their input
+                 */ 
+                if((next>='0')&&(next<='9')&&(((char) prompt_getch())=='\n')){
+                    ten = true;
+                    ones = next - '0';
+                    render_print(window, cursor++, space+3, "%c\n", next);
+                }else{
+                    //print the \n for formatting
+                    render_print(window, cursor++, space+sizeof(coords)+1, "\n");
+                }
+
+                //if it wasn't a 10 and too long, print informative error message and loop
+                if((next!='\n')&&(!ten)){
+                    
+                    //clean up user input 
+                    while(next!='\n'){
+                        next=prompt_getch();
+                    }
+
+                    //print error message split over three lines to move our cursor
+                    render_print(window, cursor++, 1, "Invalid input. Try again. Remember, the format is LETTER,NUMBER\n");
+                    render_print(window, cursor++, 1, " with a capital letter, a comma between the letter and number,\n");
+                    render_print(window, cursor, 1, " and no spaces! : ");
+                    space = strlen("and no spaces! : ")+1;
+                    continue;
+                }
+            }else{
+            //in this portion, the first input character was not a 1
+
+                //print a newline to match formatting above
+                render_print(window, cursor++, space+sizeof(coords)+1, "\n");
+
+                //if input was too long, print informative error message and loop
+                if(next!='\n'){
+
+                    //clean up user input
+                    while(next!='\n'){
+                        next=prompt_getch();
+                    }
+
+                    //print error message split over three lines to move our cursor
+                    render_print(window, cursor++, 1, "Invalid input. Try again. Remember, the format is LETTER,NUMBER\n");
+                    render_print(window, cursor++, 1, " with a capital letter, a comma between the letter and number,\n");
+                    render_print(window, cursor, 1, " and no spaces! : ");
+                    space = strlen("and no spaces! : ")+1;
+                    continue;
+                }
+            }
+
+            //to get to this point, the input in coords must be x,x and there may or may not be a 10 input
+
+            //save these for later use
+            char letter = coords[0];
+            char number = coords[2];
+            bool validL = false;
+            bool validN = false;
+            char possibleL = 'A';
+            int possibleN = 1;
+
+            //loop through all possible valid letter values and break loop if match is found
+            for (int i = 0; i < NCOLS; i++){
+                if (letter==possibleL) {
+                    validL = true;
+                    break;
+                }
+                possibleL++;
+            }
+
+            //convert letter to int value
+            int intLetter = possibleL - 'A' +1;
+
+            //loop through all possible valid numerical values and break loop if match is found
+            for (int i = 0; i < NROWS; i++){
+                char array[2] = {number, '\0'};
+                if ((atoi(array))==possibleN){
+                    validN = true;
+                    break;
+                }
+                possibleN++;
+            }
+
+            //replace n value with the two-digit row if there was one, which has to be on the board too
+            if(ten&&validN){
+                possibleN = 10 + ones;
+                validN = possibleN <= NROWS;
+            }
+
+            //if both values are valid, end while loop and store values in string to be returned
+            if(validL && validN){
+                supa=false;
+                int validCoordinates[2] = {intLetter, possibleN};
+                yay=validCoordinates;
+                return yay;
+            }
+        }else{
+            //if user didn't have short input
+            if(!shortInput){
+                //get the next character - should either be a \n or garbage since here the input did not match the specifications
+                char next = (char) prompt_getch();
+
+                //clean up user input 
+                while(next!='\n'){
+                    next=prompt_getch();
+                }
+            }
+
+            /**increment cursor from before while loop informative message (and from successive error 
+             * messages that don't increment the cursor) */
+            cursor++;
+        }
+        
+        //print error message split over three lines to move our cursor
+        render_print(window, cursor++, 1, "Invalid input. Try again. Remember, the format is LETTER,NUMBER\n");
+        render_print(window, cursor++, 1, " with a capital letter, a comma between the letter and number, \n");
+        render_print(window, cursor, 1, " and no spaces! : ");
+        space = strlen("and no spaces! : ")+1;
+    }
+
+    //this point should never be reached
+    return NULL;
+} 
+
+
+
+/**
+ * Read one line of input and return its first character (the newline if the line is empty)
+ */
+static char readChoice(){
+    char first = prompt_getch();
+    char next = first;
+    while (next != '\n') next = prompt_getch();
+    return first;
+}
+
+/**autoPlace
+ *  autoPlace asks the user whether they want their fleet placed for them. If they do, it places
+ *  a random fleet on board and lets them shuffle it until they're happy with it.
+ *  Returns true if the fleet was placed, false if the user wants to place it by hand.
+ */
+static bool autoPlace(board_t * board, WINDOW * window, WINDOW * playerWindow){
+    render_print(window, cursor++, 1, "Type 'A' to place your fleet automatically, or hit enter to place it yourself.\n");
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Type 'A' to place your fleet automatically, or hit enter to place it yourself.\n");
+    char choice = readChoice();
+    if (choice != 'A' && choice != 'a') return false;
+
+    rng_t rng;
+    rng_seed(&rng, ((uint64_t)time(NULL) << 20) ^ getpid());
+    do {
+        board_random_fleet(board, &rng);
+        draw_player_board(playerWindow, board);
+        render_print(window, cursor++, 1, "Type 'R' to shuffle your fleet again, or hit enter to keep it.\n");
+        free(most_recent_prompt);
+        most_recent_prompt = strdup("Type 'R' to shuffle your fleet again, or hit enter to keep it.\n");
+        choice = readChoice();
+    } while (choice == 'R' || choice == 'r');
+
+    //clean the input window and print exit message
+    render_erase(window);
+    render_box(window);
+    cursor = INIT_CURSOR;
+    render_print(window, cursor++, 1, "Board setup complete, enjoy the game!\n");
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Board setup complete, enjoy the game!\n");
+    return true;
+}
+
+/**validPlayer
+ *  validPlayer asks which player to attack in a match with more than two players and loops until
+ *  the user types the number of one that can be attacked (inGame[seat] is true; Player 1 is seat 0).
+ *  It returns that player's seat.
+ */
+int validPlayer(WINDOW * window, const bool * inGame, int players){
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Which player do you want to attack? ");
+
+    //save horizontal indentation for cursor
+    space = strlen("Which player do you want to attack? ")+1;
+    render_print(window, cursor, 1, "Which player do you want to attack? ");
+
+    //loop until we have valid input
+    while (true){
+
+        //collect up to BUFFERSIZE characters of the line, then drop the rest
+        char number[BUFFERSIZE+1];
+        int len = 0;
+        int ch;
+        while ((ch = prompt_getch()) != '\n'){
+            if (len < BUFFERSIZE) number[len++] = (char) ch;
+        }
+        number[len] = '\0';
+
+        //print user input so they can see what they wrote
+        render_print(window, cursor++, space, "%s", number);
+
+        //a player number, in range, that can still be attacked
+        char * end;
+        long player = strtol(number, &end, 10);
+        if (len > 0 && *end == '\0' && player >= 1 && player <= players && inGame[player-1]){
+            return player-1;
+        }
+
+        render_print(window, cursor, 1, "That player can't be attacked, try again: ");
+        space = strlen("That player can't be attacked, try again: ")+1;
+    }
+}//validPlayer
+
+
+
+/**makeBoard
+ *  makeBoard takes the input window and the player's board window.
+ *  makeBoard loops through all of the ships from the above shipArray and places them on the board based on
+ *  user input from the helper functions seen above. It returns the initialized board on success and an empty 
+ *  board on failure, but it shouldn't be able to fail.
+ */
+board_t makeBoard(WINDOW * window, WINDOW * playerWindow){
+    most_recent_prompt = strdup("first instance of strdup to avoid bugs! :)");
+    //make a new board and pointer to it
+    board_t board;
+    // board_t *boardPtr = malloc((sizeof(cell_t))*(NROWS+1)*(NCOLS+1));
+    // boardPtr = &board;
+    initBoard(&board);
+
+    //make a new ship location proposal to be vetted below
+    shipLocation_t proposal;
+
+    //give user the option to have the fleet placed for them
+    if (autoPlace(&board, window, playerWindow)) {
+        //reset cursor to top of box
+        cursor = INIT_CURSOR;
+        return board;
+    }
+
+    //loop through the different types of ships using the ship array.
+    for (int i = 0; i < NDIFSHIPS; i++){ 
+        //If any validation checks fail, we will print an error message and restart the current iteration of the loop
+
+        //save ship we're on as current
+        shipType_t current = shipArray[i]; 
+        
+        //give user info on which ship we're using 
+        render_print(window, cursor++, 1, "Current Ship: %s\n", current.name);
+        render_print(window, cursor++, 1, "Ship Length: %d\n", current.size);
+        int nameLen = strlen(current.name);
+        int ourWords = strlen("Current Ship: \nShip Length: \n");
+        free(most_recent_prompt);
+        most_recent_prompt = malloc(ourWords+nameLen+1+1);//extra 1 for ship length
+        sprintf(most_recent_prompt, "Current Ship: %s\nShip Length: %d\n", current.name, current.size);
+
+
+
+        //prompt user to give us their orientation for the ship and save it in bigO
+        enum Orientation bigO = INVALID;
+        bigO = validOrt(window); //this will not return until it's a valid orientation.
+        if(bigO==INVALID) {
+            render_print(window, cursor++, 1, "INVALID ORIENTATION. Restarting this ship placement.\n");
+            free(most_recent_prompt);
+            most_recent_prompt = strdup("INVALID ORIENTATION. Restarting this ship placement.\n");
+            i--;
+            continue;
+        }
+
+        //prompt user to give us their starting coordinates for the ship and save them into coords
+        int coords[2] = {0, 0};
+        memcpy(coords, validCoords(coords, window, "Please input coordinates for the start point of your ship (ex: A,1): \0"), (2* sizeof(int)));
+        if(coords[0] == 0 || coords[1]==0) {
+            render_print(window, cursor++, 1, "INVALID COORDINATES. Restarting this ship placement.\n");
+            free(most_recent_prompt);
+            most_recent_prompt = strdup("INVALID COORDINATES. Restarting this ship placement.\n");
+            i--;
+            continue;
+        }
+
+        //initialize proposal with valid values
+        proposal.orientation = bigO;
+        proposal.startx = coords[0];
+        proposal.starty = coords[1];
+        proposal.shipType = current;
+        proposal.sunk=false;
+
+        //look up proposal among the legal placements; if it isn't one, it crosses the bounds of the board
+        const placement_t * placement = placement_find(proposal);
+        if(placement == NULL) {
+            render_print(window, cursor++, 1, "INVALID PLACEMENT-- BOUNDARY CROSSING. Restarting this ship placement.\n");
+            free(most_recent_prompt);
+            most_recent_prompt = strdup("INVALID PLACEMENT-- BOUNDARY CROSSING. Restarting this ship placement.\n");
+            i--;
+            continue;
+        }
+
+        //check if proposal shipLocation will overlap with another ship's placement, and if not, update board
+        if(!placement_fits(&board, placement)){
+            render_print(window, cursor++, 1, "INVALID PLACEMENT-- OVERLAP. Restarting this ship placement.\n");
+            free(most_recent_prompt);
+            most_recent_prompt = strdup("INVALID PLACEMENT-- OVERLAP. Restarting this ship placement.\n");
+            i--;
+            continue;
+        } else {
+            //put ship i on the board
+            board_place(&board, i, placement);
+        }
+
+        //inform user of success
+        render_print(window, cursor++, 1, "Valid ship placement.\n");
+        free(most_recent_prompt);
+        most_recent_prompt = strdup("Valid ship placement.\n");
+       
+        //give user option to start board over
+        render_print(window, cursor++, 1, "If you would like to reset your board, you may now type in 'R'. Otherwise, hit enter.\n");
+        free(most_recent_prompt);
+        most_recent_prompt = strdup("If you would like to reset your board, you may now type in 'R'. Otherwise, hit enter.\n");
+        
+        //store input
+        char input;
+        input = prompt_getch();
+
+        //loop until we receive valid input
+        while(input != '\n' && input != 'R' && input != 'r'){
+            render_print(window, cursor, 1, "Invalid input: please input R to reset or hit enter to continue: ");
+            input = (char) prompt_getch();
+            render_print(window, cursor++, strlen("Invalid input: please input R to reset or hit enter to continue: ")+1, ": %c\n", input);
+            free(most_recent_prompt);
+            most_recent_prompt = strdup("Invalid input: please input R to reset or hit enter to continue: ");
+        }
+
+        //if user wanted to reset board, wipe the board and reset i to -1 to start the loop all the way over
+        if(input == 'R' || input == 'r') {
+            initBoard(&board);
+            i = -1;
+        }
+
+        //update player's board screen and clean the input window
+        draw_player_board(playerWindow, &board);
+        render_erase(window);
+        render_box(window);
+        cursor = INIT_CURSOR;
+    }
+    
+    //print exit message
+    render_print(window, cursor++, 1, "Board setup complete, enjoy the game!\n");
+    free(most_recent_prompt);
+    most_recent_prompt = strdup("Board setup complete, enjoy the game!\n");
+    // free(most_recent_prompt);
+
+    //reset cursor to top of box
+    cursor = INIT_CURSOR;
+
+    //return initialized box
+    return board;
+}
+
+
+/** updateBoardAfterGuess
+ *  Function that updates the board based on the player's guess
+ *  Takes a board, coordinates, bools giving information about the
+ *  specified cell (to be updated), and the user's input window
+ */
+void updateBoardAfterGuess(board_t *board, int x, int y, bool *isHit, bool *isSunk, WINDOW *window) {
+    guess_result_t result = board_guess(board, x, y);
+    *isHit = result == GUESS_HIT || result == GUESS_SUNK;
+    *isSunk = result == GUESS_SUNK;
+
+    if (result == GUESS_INVALID) {
+        render_print(window, cursor++, 1, "Invalid coordinates.\n");
+        free(most_recent_prompt);
+        most_recent_prompt = strdup("Invalid coordinates.\n");
+    } else if (result == GUESS_REPEATED) {
+        render_print(window, cursor++, 1, "Your opponent guessed an already guessed cell...They lost a turn!\n");
+        free(most_recent_prompt);
+        most_recent_prompt = strdup("Your opponent guessed an already guessed cell...They lost a turn!\n");
+    } else if (result == GUESS_MISS) {
+        render_print(window, cursor++, 1, "Your opponent missed!\n");
+        free(most_recent_prompt);
+        most_recent_prompt = strdup("Your opponent missed!\n");
+    } else {
+        // Get the ship occupying that cell
+        const shipType_t *ship = &shipArray[board_ship_at(board, x, y)];
+        const char *format = *isSunk ? "Your %s has been sunk!\n" : "Your %s got hit!\n";
+        render_print(window, cursor++, 1, format, ship->name);
+        free(most_recent_prompt);
+        int strlength = strlen("Your  has been sunk!\n") + 1;
+        strlength += strlen(ship->name);
+        most_recent_prompt = malloc(sizeof(char)*strlength);
+        sprintf(most_recent_prompt, format, ship->name);
+    }
+}
+
+/**printStatus
+ *  used by us during debugging to print the occupation status of each cell
+ */
+void printStatus(board_t board, WINDOW * window, char* filename){
+    FILE* boardContent = fopen(filename, "w+");
+    for (int i = 1; i < NCOLS+1; i++){
+        for (int j = 1; j < NROWS+1; j++){
+            fprintf(boardContent, "Cell %d,%d is occupied (1 is true): %d\n", i, j, bb_test(&board.occupied, i, j));
+        }
+    }
+    fclose(boardContent);
+}
+
+/**
+ * Wrap the prompt window back to the top if the cursor has reached its bottom: clear it and
+ * reprint the most recent prompt. Runs on the game thread right before it waits (for a key or
+ * for the next turn), so it never races with the code that moves the cursor.
+ */
+void check_cursor() {
+    if (tracked_prompt_win == NULL) return;
+
+    // Check if the cursor has reached or exceeded the bottom of the window
+    if (cursor >= tracked_prompt_rows - 2) {
+        render_erase(tracked_prompt_win);   // Clear the window
+        render_box(tracked_prompt_win);     // Redraw the box
+
+        // Print the most recent prompt at the top of the prompt window
+        if (most_recent_prompt && strlen(most_recent_prompt) > 0) {
+            render_print(tracked_prompt_win, INIT_CURSOR, 1, "%s", most_recent_prompt);
+            cursor = INIT_CURSOR + 1;   // Set the cursor just below the most recent prompt
+            if((strstr(most_recent_prompt, "A,1") != NULL) ||(strstr(most_recent_prompt, "V/H") != NULL))  cursor = INIT_CURSOR;
+            space = strlen(most_recent_prompt) + 1;
+        } else {
+            cursor = INIT_CURSOR;
+        }
+    }
+}
+
+/**
+ * Wait for the next key press, wrapping the prompt window first if it's full, or end the game
+ * if the terminal has hung up
+ *
+ * @return The key
+ */
+int prompt_getch() {
+    check_cursor();
+    int ch = render_getch();
+    if (ch == ERR) {
+        // The terminal hung up: leave, and the opponent sees the connection close
+        end_curses();
+        fprintf(stderr, "The terminal closed, leaving the game\n");
+        exit(EXIT_FAILURE);
+    }
+    return ch;
+}
+
+/** 
+ * Start keeping the cursor inside the prompt window
+ * 
+ * @param prompt_win The prompt window to monitor
+ */
+void start_cursor_tracking(WINDOW* prompt_win) {
+    tracked_prompt_rows = getmaxy(prompt_win);
+    tracked_prompt_win = prompt_win;
+}
+
+/**
+ * Stop keeping the cursor inside the prompt window
+ */
+void stop_cursor_tracking() {
+    tracked_prompt_win = NULL;
+}
+
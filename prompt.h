@@ -0,0 +1,87 @@
+/**
+ * The interactive side of the board: curses prompts for placing ships and entering
+ * coordinates, messages about the opponent's guesses, and keeping the prompt window's cursor
+ * in bounds. Everything here draws through the render thread.
+ */
+
+#pragma once
+#include <curses.h>
+#include <stddef.h>
+
+#include "board.h"
+
+#define INIT_CURSOR 1 //vertical start index for the cursor of the user input window
+
+// Declare cursor as an external variable to prevent multiple definition errors
+extern size_t cursor;
+extern char * most_recent_prompt;
+extern int space;
+
+/** updateBoardAfterGuess
+ *  Function that updates the board based on the player's guess
+ *  Takes a board, coordinates, bools giving information about the
+ *  specified cell (to be updated), and the user's input window
+ */
+void updateBoardAfterGuess(board_t *board, int x, int y, bool *isHit, bool *isSunk, WINDOW * window);
+
+/**printStatus
+ *  used by us during debugging to print the occupation status of each cell
+ */
+void printStatus(board_t board, WINDOW * window, char* filename);
+
+/**validOrt
+ *  validOrt takes the user input window 
+ *  validOrt instructs the user to give us an orientation (either "V" or "H") and loops until 
+ *  the user inputs a valid orientation. It then returns that valid orientation.
+ *  Since we handle user input here, the function is mostly error checking.
+ */
+enum Orientation validOrt(WINDOW * window);
+
+/**validCoords
+ *  validCoords takes a pointer to an int array that it will fill with the two valid coordinate
+ *  values. It also takes the user input window since it deals with user input. Since this input
+ *  is more structured and complicated, most of this function is error checking.
+ */
+int* validCoords(int * yay, WINDOW * window, char * prompt);
+
+/**validPlayer
+ *  validPlayer asks which player to attack in a match with more than two players and loops until
+ *  the user types the number of one that can be attacked (inGame[seat] is true; Player 1 is seat 0).
+ *  It returns that player's seat.
+ */
+int validPlayer(WINDOW * window, const bool * inGame, int players);
+
+/**makeBoard
+ *  makeBoard takes the input window and the player's board window.
+ *  makeBoard first offers to place the whole fleet at random, then otherwise loops through all of the ships
+ *  from the above shipArray and places them on the board based on user input from the helper functions seen above. It returns the initialized board on success and an empty 
+ *  board on failure, but it shouldn't be able to fail.
+ */
+board_t makeBoard(WINDOW * window, WINDOW * playerWindow);
+
+
+/**
+ * Start keeping the cursor inside the prompt window: check_cursor wraps the window back to the
+ * top once the cursor reaches its bottom
+ * 
+ * @param prompt_win The prompt window to monitor
+ */
+void start_cursor_tracking(WINDOW* prompt_win);
+
+/**
+ * Stop keeping the cursor inside the prompt window
+ */
+void stop_cursor_tracking();
+
+/**
+ * Wrap the prompt window back to the top if the cursor has reached its bottom
+ */
+void check_cursor();
+
+/**
+ * Wait for the next key press (read by the render thread), wrapping the prompt window first
+ * if it's full. If the terminal has hung up, nobody can answer the prompt, so the game ends.
+ *
+ * @return The key
+ */
+int prompt_getch();
@@ -0,0 +1,108 @@
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "protocol.h"
+#include "board.h"
+
+// Encode a frame into its wire format
+void encode_frame(const frame_t* frame, uint8_t* out) {
+    out[0] = PROTOCOL_VERSION;
+    out[1] = frame->type;
+    out[2] = frame->seat;
+    out[3] = frame->target;
+    out[4] = frame->x;
+    out[5] = frame->y;
+    out[6] = frame->outcome;
+    out[7] = frame->ship;
+
+    // READY and WATCH say which rules the sender plays by
+    if (frame->type == MSG_READY || frame->type == MSG_WATCH) {
+        out[4] = NCOLS;
+        out[5] = NROWS;
+        out[6] = NDIFSHIPS;
+        out[7] = FLEET_CELLS;
+    }
+}
+
+// Decode and validate a frame
+int decode_frame(const uint8_t* in, frame_t* frame) {
+    if (in[0] != PROTOCOL_VERSION) return -1;
+
+    frame->type = in[1];
+    frame->seat = in[2];
+    frame->target = in[3];
+    frame->x = in[4];
+    frame->y = in[5];
+    frame->outcome = in[6];
+    frame->ship = in[7];
+
+    if (frame->seat >= MAX_SEATS) return -1;
+
+    switch (frame->type) {
+        case MSG_READY:
+        case MSG_WATCH:
+            // Both sides have to play on the same board with the same fleet
+            if (frame->x != NCOLS || frame->y != NROWS || frame->outcome != NDIFSHIPS || frame->ship != FLEET_CELLS) {
+                return -1;
+            }
+            // The seat count, if the sender gave one, covers the receiver's seat
+            if (frame->target != 0 && (frame->target < 2 || frame->target > MAX_SEATS || frame->seat >= frame->target)) {
+                return -1;
+            }
+            return 0;
+        case MSG_QUIT:
+            return 0;
+        case MSG_RESULT:
+            if (frame->outcome > RESULT_SUNK) return -1;
+            // A sunk result must name the ship, anything else must not
+            if (frame->outcome == RESULT_SUNK ? frame->ship >= NDIFSHIPS : frame->ship != NO_SHIP) return -1;
+            // fall through to check the coordinates
+        case MSG_ATTACK:
+            if (frame->target >= MAX_SEATS) return -1;
+            if (frame->x < 1 || frame->x > NCOLS || frame->y < 1 || frame->y > NROWS) return -1;
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+// Send one frame across a socket
+int send_frame(int fd, const frame_t* frame) {
+    return send_frames(fd, frame, 1);
+}
+
+// Send several frames across a socket with one write
+int send_frames(int fd, const frame_t* frames, size_t count) {
+    if (count == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    uint8_t buffer[count * FRAME_SIZE];
+    for (size_t i = 0; i < count; i++) {
+        encode_frame(&frames[i], buffer + i * FRAME_SIZE);
+    }
+
+    // Frames are tiny, so this is almost always a single write
+    size_t bytes_written = 0;
+    while (bytes_written < sizeof(buffer)) {
+        ssize_t rc = write(fd, buffer + bytes_written, sizeof(buffer) - bytes_written);
+        if (rc == -1 && errno == EINTR) continue;
+        if (rc <= 0) return -1;
+        bytes_written += rc;
+    }
+    return 0;
+}
+
+// Receive one frame from a connection
+int receive_frame(msg_conn_t* conn, frame_t* frame) {
+    uint8_t buffer[FRAME_SIZE];
+    if (receive_bytes(conn, buffer, FRAME_SIZE) == -1) return -1;
+
+    if (decode_frame(buffer, frame) == -1) {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * Binary wire protocol between players (and the match host).
+ *
+ * Every message is one fixed-size frame of FRAME_SIZE bytes, so a receiver always knows how much
+ * to read and never has to scan text:
+ *
+ *   byte 0  protocol version (PROTOCOL_VERSION)
+ *   byte 1  message type (msg_type_t)
+ *   byte 2  seat    - READY: the receiver's seat (seat 0 shoots first); ATTACK/RESULT: the shooter's seat;
+ *                     QUIT: the seat leaving the match; WATCH: 0
+ *   byte 3  target  - ATTACK/RESULT: the seat being shot at; READY/WATCH from the host: the number of
+ *                     seats in the match (0 from a player, or from "./battleship server": two)
+ *   byte 4  x       - ATTACK/RESULT: column, 1..NCOLS; READY/WATCH: NCOLS
+ *   byte 5  y       - ATTACK/RESULT: row, 1..NROWS; READY/WATCH: NROWS
+ *   byte 6  outcome - RESULT: attack_outcome_t; READY/WATCH: NDIFSHIPS
+ *   byte 7  ship    - RESULT with RESULT_SUNK: index of the sunk ship in shipArray, otherwise NO_SHIP;
+ *                     READY/WATCH: FLEET_CELLS
+ *
+ * encode_frame fills in the ruleset bytes of READY and WATCH frames itself, and decode_frame rejects
+ * one whose ruleset (rules.h) differs from ours, so builds for different rules never meet.
+ *
+ * A match hosted by "./battleship host <port> <backend> <players>" has up to MAX_SEATS seats. Seats
+ * shoot in order, each ATTACK naming any seat still in the match; only the target gets the ATTACK,
+ * and its RESULT goes to every other seat, so everybody can follow every board. If the attacker
+ * leaves before the target answers, the RESULT still goes to everybody else, but the turn has
+ * moved on already. A seat is out once its whole fleet is sunk or it leaves, and the last seat left wins.
+ *
+ * A client that opens with WATCH instead of READY is a spectator. The host answers with a WATCH
+ * naming the seat count of the match it features, then streams that match's public events: every
+ * RESULT (which carries the shot, hit or miss, and sunk ship) and every QUIT. When the match ends
+ * the next one to start is featured, announced by another WATCH.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "gameMessage.h"
+
+#define PROTOCOL_VERSION 2
+#define FRAME_SIZE 8
+#define MAX_SEATS 16    // most seats in one match
+#define NO_SHIP 0xFF    // ship field when no ship was sunk
+
+//message types
+typedef enum msg_type {
+    MSG_READY = 1,  // fleet placed (to the host/opponent) or match starting (from the host)
+    MSG_ATTACK,     // shot at (x, y)
+    MSG_RESULT,     // result of the shot at (x, y)
+    MSG_QUIT,       // the sender is leaving the match
+    MSG_WATCH       // spectate (to the host) or a featured match starting (from the host)
+} msg_type_t;
+
+//possible results of an attack
+typedef enum attack_outcome {
+    RESULT_MISS,
+    RESULT_HIT,
+    RESULT_SUNK
+} attack_outcome_t;
+
+/**
+ * frame struct, stores the decoded fields of one protocol message
+ */
+typedef struct frame {
+    uint8_t type;
+    uint8_t seat;
+    uint8_t target;
+    uint8_t x;
+    uint8_t y;
+    uint8_t outcome;
+    uint8_t ship;
+} frame_t;
+
+/**
+ * Encode a frame into its wire format
+ *
+ * @param frame The frame to encode
+ * @param out   Buffer of FRAME_SIZE bytes to write to
+ */
+void encode_frame(const frame_t* frame, uint8_t* out);
+
+/**
+ * Decode and validate a frame. Checks the version, the type, and that every field used by that
+ * type is in range, so callers can index boards and shipArray with the result directly.
+ *
+ * @param in    Buffer of FRAME_SIZE bytes to read from
+ * @param frame The frame to fill in
+ * @return 0 on success, -1 if the frame is malformed
+ */
+int decode_frame(const uint8_t* in, frame_t* frame);
+
+/**
+ * Send one frame across a socket, like send_frames.
+ *
+ * @param fd    The socket
+ * @param frame The frame to send
+ * @return 0 on success, -1 on error
+ */
+int send_frame(int fd, const frame_t* frame);
+
+/**
+ * Send several frames across a socket with one write, writing again after a signal or a short write.
+ *
+ * On a non-blocking socket whose send buffer is full this fails with EAGAIN, possibly after part
+ * of a frame has gone out, and nothing keeps the rest: the stream is out of step, so the caller
+ * must hang up rather than send anything else.
+ *
+ * @param fd     The socket
+ * @param frames The frames to send
+ * @param count  Number of frames, at least 1
+ * @return 0 on success, -1 on error (errno is EINVAL if count is 0)
+ */
+int send_frames(int fd, const frame_t* frames, size_t count);
+
+/**
+ * Receive one frame from a connection. Frames that arrived together are served from the
+ * connection's buffer without another read.
+ *
+ * @param conn  The connection
+ * @param frame The frame to fill in
+ * @return 0 on success, -1 on error or a malformed frame (errno is EINVAL for malformed frames,
+ *         and ECONNRESET if the peer closed the connection)
+ */
+int receive_frame(msg_conn_t* conn, frame_t* frame);
@@ -0,0 +1,411 @@
+/**
+ * References for the command queue
+ *
+ * Dmitry Vyukov's bounded MPMC queue - https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ */
+
+#include "render.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "graphics.h"
+
+#define MAX_DIRTY_WINDOWS 8 // distinct windows one frame can touch
+#define KEY_QUEUE_SIZE 256  // buffered key presses
+
+//things the render thread can be asked to do
+typedef enum render_op {
+    RENDER_PRINT,
+    RENDER_ERASE,
+    RENDER_BOX,
+    RENDER_PLAYER_BOARD,
+    RENDER_OPPONENT_BOARD
+} render_op_t;
+
+/**
+ * render_cmd struct, stores one queued draw command
+ */
+typedef struct render_cmd {
+    render_op_t op;
+    WINDOW* win;
+    int y;
+    int x;
+    union {
+        char text[RENDER_TEXT_MAX];
+        board_t board;
+    };
+} render_cmd_t;
+
+/**
+ * render_slot struct, stores one queue entry. seq says whose turn the slot is: it equals the
+ * enqueue position when a producer may fill it, and that position + 1 once it holds a command.
+ */
+typedef struct render_slot {
+    atomic_size_t seq;
+    render_cmd_t cmd;
+} render_slot_t;
+
+//the command queue: any thread enqueues, only the render thread dequeues
+static render_slot_t slots[RENDER_QUEUE_SIZE];
+static atomic_size_t enqueue_pos;
+static size_t dequeue_pos;
+
+//waking the render thread: a pipe it polls along with the keyboard, written at most once per wakeup
+static int wake_pipe[2] = {-1, -1};
+static atomic_bool wake_pending;
+static atomic_bool stop_requested;
+static pthread_t render_thread;
+static bool running = false;
+
+//key presses read by the render thread, waiting for render_getch
+static pthread_mutex_t key_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t key_cond = PTHREAD_COND_INITIALIZER;
+static int keys[KEY_QUEUE_SIZE];
+static size_t key_head, key_tail;
+static bool keys_closed;    // the terminal hung up or stdin hit end of file: no more keys are coming
+
+/**
+ * Wake the render thread unless a wakeup is already on its way
+ */
+static void render_wake() {
+    if (!atomic_exchange(&wake_pending, true)) {
+        char byte = 0;
+        if (write(wake_pipe[1], &byte, 1) == -1 && errno != EAGAIN) perror("Failed to wake render thread");
+    }
+}
+
+/**
+ * Claim a queue slot for a new command. Only waits if the render thread is a whole queue behind.
+ *
+ * @param pos_out Set to the slot's queue position, for render_publish
+ * @return The slot to fill in; publish it with render_publish
+ */
+static render_slot_t* render_claim(size_t* pos_out) {
+    size_t pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+    while (true) {
+        render_slot_t* slot = &slots[pos & (RENDER_QUEUE_SIZE - 1)];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            // The slot is free; take it unless another producer got there first
+            if (atomic_compare_exchange_weak_explicit(&enqueue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                *pos_out = pos;
+                return slot;
+            }
+        } else if (diff < 0) {
+            // The queue is full: let the render thread catch up
+            render_wake();
+            sched_yield();
+            pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+        } else {
+            pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * Hand a filled-in slot to the render thread
+ */
+static void render_publish(render_slot_t* slot, size_t pos) {
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    render_wake();
+}
+
+/**
+ * Take the oldest queued command (render thread only)
+ *
+ * @param cmd Where to copy the command
+ * @return true if there was one
+ */
+static bool render_dequeue(render_cmd_t* cmd) {
+    render_slot_t* slot = &slots[dequeue_pos & (RENDER_QUEUE_SIZE - 1)];
+    size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (seq != dequeue_pos + 1) return false;
+
+    *cmd = slot->cmd;
+    atomic_store_explicit(&slot->seq, dequeue_pos + RENDER_QUEUE_SIZE, memory_order_release);
+    dequeue_pos++;
+    return true;
+}
+
+/**
+ * Queue a command that only needs a window
+ */
+static void render_simple(render_op_t op, WINDOW* win) {
+    if (!running) return;
+
+    size_t pos;
+    render_slot_t* slot = render_claim(&pos);
+    slot->cmd.op = op;
+    slot->cmd.win = win;
+    render_publish(slot, pos);
+}
+
+/**
+ * Run one command against curses (render thread only)
+ */
+static void render_apply(const render_cmd_t* cmd) {
+    switch (cmd->op) {
+        case RENDER_PRINT:
+            mvwprintw(cmd->win, cmd->y, cmd->x, "%s", cmd->text);
+            break;
+        case RENDER_ERASE:
+            werase(cmd->win);
+            forget_board_frame(cmd->win);
+            break;
+        case RENDER_BOX:
+            box(cmd->win, 0, 0);
+            break;
+        case RENDER_PLAYER_BOARD:
+            paint_player_board(cmd->win, &cmd->board);
+            break;
+        case RENDER_OPPONENT_BOARD:
+            paint_opponent_board(cmd->win, &cmd->board);
+            break;
+    }
+}
+
+/**
+ * Pass every key curses has ready to render_getch (render thread only)
+ *
+ * @return The number of keys read
+ */
+static int render_read_keys() {
+    int ch, count = 0;
+    while ((ch = wgetch(stdscr)) != ERR) {
+        count++;
+        pthread_mutex_lock(&key_mutex);
+        // Drop keys nobody is reading rather than block the render thread
+        if (key_tail - key_head < KEY_QUEUE_SIZE) {
+            keys[key_tail++ % KEY_QUEUE_SIZE] = ch;
+            pthread_cond_signal(&key_cond);
+        }
+        pthread_mutex_unlock(&key_mutex);
+    }
+    return count;
+}
+
+/**
+ * Tell render_getch no more keys are coming, waking everybody waiting for one (render thread only)
+ */
+static void render_close_keys() {
+    pthread_mutex_lock(&key_mutex);
+    keys_closed = true;
+    pthread_cond_broadcast(&key_cond);
+    pthread_mutex_unlock(&key_mutex);
+}
+
+/**
+ * Check whether stdin is readable only because it hit end of file
+ *
+ * @param keys Keys just read from it
+ */
+static bool stdin_at_eof(int keys) {
+    int pending;
+    if (ioctl(STDIN_FILENO, FIONREAD, &pending) == 0) return pending == 0;
+    // Some devices (like /dev/null) can't say: readable with no keys in it is the end
+    return keys == 0;
+}
+
+/**
+ * Render thread: draw a frame whenever commands arrive, and read keys whenever they're pressed
+ */
+static void* render_loop(void* arg) {
+    struct pollfd fds[2] = {{.fd = wake_pipe[0], .events = POLLIN}, {.fd = STDIN_FILENO, .events = POLLIN}};
+
+    while (true) {
+        bool stopping = atomic_load(&stop_requested);
+
+        // Clear the wakeup flag before draining, so a command queued after the drain wakes us again
+        atomic_store(&wake_pending, false);
+
+        // Apply everything queued, remembering which windows changed
+        WINDOW* dirty[MAX_DIRTY_WINDOWS];
+        int ndirty = 0;
+        render_cmd_t cmd;
+        while (render_dequeue(&cmd)) {
+            render_apply(&cmd);
+
+            bool seen = false;
+            for (int i = 0; i < ndirty; i++) seen |= dirty[i] == cmd.win;
+            if (!seen && ndirty < MAX_DIRTY_WINDOWS) {
+                dirty[ndirty++] = cmd.win;
+            } else if (!seen) {
+                wnoutrefresh(cmd.win);
+            }
+        }
+
+        // One terminal update for the whole frame
+        if (ndirty > 0) {
+            for (int i = 0; i < ndirty; i++) wnoutrefresh(dirty[i]);
+            doupdate();
+        }
+
+        if (stopping) break;
+
+        if (poll(fds, 2, -1) == -1 && errno != EINTR) {
+            perror("Render thread poll failed");
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            char drain[64];
+            while (read(wake_pipe[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+        if (fds[1].revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) {
+            int nkeys = render_read_keys();
+            // After a hangup or end of file, poll would report stdin ready forever: stop polling it
+            if ((fds[1].revents & (POLLHUP | POLLERR | POLLNVAL)) || stdin_at_eof(nkeys)) {
+                fds[1].fd = -1;
+                render_close_keys();
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Start the render thread
+ */
+void render_start() {
+    if (running) return;
+
+    for (size_t i = 0; i < RENDER_QUEUE_SIZE; i++) {
+        atomic_init(&slots[i].seq, i);
+    }
+    atomic_init(&enqueue_pos, 0);
+    dequeue_pos = 0;
+    atomic_init(&wake_pending, false);
+    atomic_init(&stop_requested, false);
+    key_head = key_tail = 0;
+    keys_closed = false;
+
+    if (pipe(wake_pipe) == -1) {
+        perror("Failed to create render pipe");
+        return;
+    }
+    fcntl(wake_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(wake_pipe[1], F_SETFL, O_NONBLOCK);
+
+    // The render thread reads keys as they arrive instead of blocking in wgetch
+    nodelay(stdscr, TRUE);
+
+    running = true;
+    pthread_create(&render_thread, NULL, render_loop, NULL);
+}
+
+/**
+ * Draw everything still queued, then stop the render thread
+ */
+void render_stop() {
+    if (!running) return;
+
+    atomic_store(&stop_requested, true);
+    char byte = 0;
+    if (write(wake_pipe[1], &byte, 1) == -1 && errno != EAGAIN) perror("Failed to wake render thread");
+    pthread_join(render_thread, NULL);
+    running = false;
+
+    close(wake_pipe[0]);
+    close(wake_pipe[1]);
+    nodelay(stdscr, FALSE);
+}
+
+/**
+ * Queue formatted text, like mvwprintw
+ */
+void render_print(WINDOW* win, int y, int x, const char* format, ...) {
+    if (!running) return;
+
+    size_t pos;
+    render_slot_t* slot = render_claim(&pos);
+    slot->cmd.op = RENDER_PRINT;
+    slot->cmd.win = win;
+    slot->cmd.y = y;
+    slot->cmd.x = x;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(slot->cmd.text, RENDER_TEXT_MAX, format, args);
+    va_end(args);
+
+    render_publish(slot, pos);
+}
+
+/**
+ * Queue clearing a window, like werase
+ */
+void render_erase(WINDOW* win) {
+    render_simple(RENDER_ERASE, win);
+}
+
+/**
+ * Queue drawing a window's border, like box(win, 0, 0)
+ */
+void render_box(WINDOW* win) {
+    render_simple(RENDER_BOX, win);
+}
+
+/**
+ * Queue drawing a board
+ */
+void render_board(WINDOW* win, const board_t* board, bool opponent) {
+    if (!running) return;
+
+    size_t pos;
+    render_slot_t* slot = render_claim(&pos);
+    slot->cmd.op = opponent ? RENDER_OPPONENT_BOARD : RENDER_PLAYER_BOARD;
+    slot->cmd.win = win;
+    slot->cmd.board = *board;
+    render_publish(slot, pos);
+}
+
+/**
+ * Wait for the next key press
+ */
+int render_getch() {
+    pthread_mutex_lock(&key_mutex);
+    while (key_head == key_tail && !keys_closed) {
+        pthread_cond_wait(&key_cond, &key_mutex);
+    }
+    int ch = ERR;
+    if (key_head != key_tail) ch = keys[key_head++ % KEY_QUEUE_SIZE];
+    pthread_mutex_unlock(&key_mutex);
+    return ch;
+}
+
+/**
+ * Wait up to timeout_ms milliseconds for the next key press
+ */
+int render_getch_timeout(int timeout_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock(&key_mutex);
+    while (key_head == key_tail && !keys_closed) {
+        if (pthread_cond_timedwait(&key_cond, &key_mutex, &deadline) == ETIMEDOUT) break;
+    }
+    int ch = ERR;
+    if (key_head != key_tail) ch = keys[key_head++ % KEY_QUEUE_SIZE];
+    pthread_mutex_unlock(&key_mutex);
+    return ch;
+}
@@ -0,0 +1,79 @@
+/**
+ * Render thread - the only thread that touches curses once the windows exist.
+ *
+ * Game code queues draw commands (text, erases, borders, board snapshots) on a lock-free
+ * multi-producer queue and carries on without waiting for the terminal. The render thread drains
+ * everything queued, refreshes the windows that changed, and pushes the frame to the terminal with
+ * a single doupdate. It also reads the keyboard and hands key presses to render_getch.
+ */
+
+#pragma once
+
+#include <curses.h>
+#include <stdbool.h>
+
+#include "board.h"
+
+#define RENDER_QUEUE_SIZE 512   // queued draw commands (power of two)
+#define RENDER_TEXT_MAX 160     // longest line of text one command can print
+
+/**
+ * Start the render thread. Call after the windows are created; from then on draw through the
+ * functions below instead of calling curses directly. Until then (and in headless runs, which
+ * never start it) the drawing functions do nothing.
+ */
+void render_start();
+
+/**
+ * Draw everything still queued, then stop the render thread. Does nothing if it isn't running.
+ */
+void render_stop();
+
+/**
+ * Queue formatted text, like mvwprintw
+ *
+ * @param win    The window to print in
+ * @param y      Row in the window
+ * @param x      Column in the window
+ * @param format printf-style format string
+ */
+void render_print(WINDOW* win, int y, int x, const char* format, ...) __attribute__((format(printf, 4, 5)));
+
+/**
+ * Queue clearing a window, like werase
+ *
+ * @param win The window
+ */
+void render_erase(WINDOW* win);
+
+/**
+ * Queue drawing a window's border, like box(win, 0, 0)
+ *
+ * @param win The window
+ */
+void render_box(WINDOW* win);
+
+/**
+ * Queue drawing a board. The board is copied, so the caller can keep changing it.
+ *
+ * @param win      The board window
+ * @param board    The board to draw
+ * @param opponent true to hide ships (the opponent's board), false to show them
+ */
+void render_board(WINDOW* win, const board_t* board, bool opponent);
+
+/**
+ * Wait for the next key press
+ *
+ * @return The key, as wgetch would return it, or ERR once the terminal has hung up (or stdin
+ *         has hit end of file) and every key read before that has been returned
+ */
+int render_getch();
+
+/**
+ * Wait up to timeout_ms milliseconds for the next key press
+ *
+ * @param timeout_ms How long to wait
+ * @return The key, or ERR if none was pressed in time (at once, if the terminal has hung up)
+ */
+int render_getch_timeout(int timeout_ms);
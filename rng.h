@@ -0,0 +1,71 @@
+/**
+ * Small, fast, seedable random numbers for bots, simulations, and fleet auto-placement
+ * (xorshift64*, seeded through splitmix64). Each thread or bot keeps its own rng_t, so nothing
+ * is shared and a seed always replays the same sequence.
+ *
+ * References
+ *
+ * Sebastiano Vigna, xorshift* and xorshift+ generators - https://prng.di.unimi.it/
+ * Daniel Lemire, Fast random integer generation in an interval - https://arxiv.org/abs/1805.10941
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * rng struct, stores one random number generator's state
+ */
+typedef struct rng {
+    uint64_t state;
+} rng_t;
+
+/**
+ * Seed a generator. Any seed is fine, including 0.
+ *
+ * @param rng  The generator
+ * @param seed The seed
+ */
+static inline void rng_seed(rng_t* rng, uint64_t seed) {
+    // splitmix64 spreads similar seeds apart and never leaves the state at 0
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    rng->state = z != 0 ? z : 1;
+}
+
+/**
+ * Get the next 64 random bits
+ *
+ * @param rng The generator
+ * @return The bits
+ */
+static inline uint64_t rng_next(rng_t* rng) {
+    uint64_t x = rng->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng->state = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * Get a uniformly random number in [0, n), with Lemire's multiply-shift. The few products that
+ * would favour some numbers are rejected and drawn again; the division that finds them only
+ * runs when the low half of a product is below n.
+ *
+ * @param rng The generator
+ * @param n   The bound (greater than 0)
+ * @return The number
+ */
+static inline uint32_t rng_below(rng_t* rng, uint32_t n) {
+    uint64_t m = (rng_next(rng) >> 32) * n;
+    if ((uint32_t)m < n) {
+        uint32_t threshold = -n % n;
+        while ((uint32_t)m < threshold) {
+            m = (rng_next(rng) >> 32) * n;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
@@ -0,0 +1,86 @@
+/**
+ * Rulesets - the board's size and the fleet each player places, fixed at compile time.
+ *
+ * A build plays exactly one ruleset, picked with "make RULES=<name>" (which defines RULES):
+ *
+ *   classic     10x10; Destroyer 2, Submarine 3, Cruiser 3, Battleship 4, Aircraft Carrier 5
+ *   seabattle   10x10; one ship of 4, two of 3, three of 2, four of 1
+ *   large       16x16; the classic fleet plus a Frigate 4 and a Supercarrier 6
+ *
+ * "make ROWS=12 COLS=14" resizes the board under any fleet, as long as every ship can have a row
+ * of its own (or every ship a column of its own), which guarantees a legal fleet exists:
+ * at least 5x5 for classic, 10x4 or 4x10 for seabattle, and 7x6 or 6x7 for large. Everything that depends on the ruleset
+ * (bitboard width, placement tables, heatmap counters, array sizes) is a compile-time constant, so
+ * every ruleset gets the same constant-folded, fully unrolled kernels the classic board does; there
+ * is no slower generic path to fall back to. Builds for different rulesets can't play each other:
+ * READY frames carry the ruleset (see protocol.h) and a mismatch is rejected.
+ *
+ * A fleet is an X-macro: FLEET(SHIP) expands SHIP(name, size) once per ship, in placement order,
+ * so code can unroll over the fleet with each size a constant.
+ */
+
+#pragma once
+
+#define RULES_CLASSIC 1
+#define RULES_SEABATTLE 2
+#define RULES_LARGE 3
+
+#ifndef RULES
+#define RULES RULES_CLASSIC
+#endif
+
+#if RULES == RULES_CLASSIC
+#define RULES_NAME "classic"
+#define RULES_ROWS 10
+#define RULES_COLS 10
+#define FLEET(SHIP) \
+    SHIP("Destroyer", 2) SHIP("Submarine", 3) SHIP("Cruiser", 3) SHIP("Battleship", 4) SHIP("Aircraft Carrier", 5)
+#elif RULES == RULES_SEABATTLE
+#define RULES_NAME "seabattle"
+#define RULES_ROWS 10
+#define RULES_COLS 10
+#define FLEET(SHIP) \
+    SHIP("Battleship", 4) SHIP("Cruiser", 3) SHIP("Cruiser", 3) SHIP("Destroyer", 2) SHIP("Destroyer", 2) \
+    SHIP("Destroyer", 2) SHIP("Torpedo Boat", 1) SHIP("Torpedo Boat", 1) SHIP("Torpedo Boat", 1) SHIP("Torpedo Boat", 1)
+#elif RULES == RULES_LARGE
+#define RULES_NAME "large"
+#define RULES_ROWS 16
+#define RULES_COLS 16
+#define FLEET(SHIP) \
+    SHIP("Destroyer", 2) SHIP("Submarine", 3) SHIP("Cruiser", 3) SHIP("Battleship", 4) SHIP("Frigate", 4) \
+    SHIP("Aircraft Carrier", 5) SHIP("Supercarrier", 6)
+#else
+#error "unknown RULES (expected RULES_CLASSIC, RULES_SEABATTLE, or RULES_LARGE)"
+#endif
+
+#ifndef NROWS
+#define NROWS RULES_ROWS //rows for game board
+#endif
+#ifndef NCOLS
+#define NCOLS RULES_COLS //columns for game board
+#endif
+
+#define RULES_COUNT_SHIP(name, size) + 1
+#define RULES_SHIP_CELLS(name, size) + (size)
+#define RULES_SHIP_SQUARE(name, size) + (size) * (size)
+
+#define NDIFSHIPS (0 FLEET(RULES_COUNT_SHIP))          //the number of ships in the fleet
+#define FLEET_CELLS (0 FLEET(RULES_SHIP_CELLS))         //cells the whole fleet covers
+#define FLEET_SQUARES (0 FLEET(RULES_SHIP_SQUARE))      //sum of the squares of the ship sizes
+
+// Coordinates are typed as a capital letter and a number, and travel in one byte each
+_Static_assert(NCOLS >= 1 && NCOLS <= 26, "columns are lettered A to Z");
+_Static_assert(NROWS >= 1 && NROWS <= 19, "rows are typed as one digit or 1 and a digit");
+_Static_assert(NROWS * NCOLS <= 256, "placement tables store bit indexes in a byte");
+_Static_assert(FLEET_CELLS < NROWS * NCOLS && FLEET_CELLS <= 255, "the fleet has to fit on the board");
+
+// Every ship fits in a row (or column) of its own, so some legal fleet always exists and
+// board_random_fleet's restarts always end
+#define RULES_FITS_ROW(name, size) && (size) <= NCOLS
+#define RULES_FITS_COLUMN(name, size) && (size) <= NROWS
+_Static_assert((NDIFSHIPS <= NROWS && (1 FLEET(RULES_FITS_ROW))) || (NDIFSHIPS <= NCOLS && (1 FLEET(RULES_FITS_COLUMN))),
+               "the board is too small for the fleet: every ship needs a row (or column) of its own");
+
+#define RULES_CHECK_SHIP(name, size) \
+    _Static_assert((size) >= 1 && (size) <= (NROWS > NCOLS ? NROWS : NCOLS), name " doesn't fit on the board");
+FLEET(RULES_CHECK_SHIP)
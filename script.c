@@ -0,0 +1,171 @@
+#include "script.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "placement.h"
+#include "protocol.h"
+
+#define SCRIPT_LINE_MAX 128 // longest script line we read; the rest of a longer line is ignored
+
+/**
+ * Read the next line that isn't blank or a comment, with surrounding whitespace stripped
+ *
+ * @param script The script
+ * @param buffer Where to store the line (SCRIPT_LINE_MAX bytes)
+ * @return The line, or NULL at the end of the script
+ */
+static char* next_line(script_t* script, char* buffer) {
+    while (fgets(buffer, SCRIPT_LINE_MAX, script->file) != NULL) {
+        script->line++;
+
+        // Drop the rest of an overlong line (only comments get that long)
+        if (strchr(buffer, '\n') == NULL) {
+            int ch;
+            while ((ch = fgetc(script->file)) != EOF && ch != '\n') {
+            }
+        }
+
+        char* start = buffer;
+        while (isspace((unsigned char)*start)) start++;
+        char* end = start + strlen(start);
+        while (end > start && isspace((unsigned char)end[-1])) end--;
+        *end = '\0';
+
+        if (*start != '\0' && *start != '#') return start;
+    }
+    return NULL;
+}
+
+/**
+ * Parse a cell written as LETTER,NUMBER (e.g. A,1 or J,10 on the classic board)
+ *
+ * @param text The text
+ * @param x    Set to the column, 1..NCOLS
+ * @param y    Set to the row, 1..NROWS
+ * @return true if text is a cell on the board
+ */
+static bool parse_cell(const char* text, int* x, int* y) {
+    char letter = toupper((unsigned char)text[0]);
+    if (letter < 'A' || letter >= 'A' + NCOLS || text[1] != ',') return false;
+
+    char* end;
+    long number = strtol(text + 2, &end, 10);
+    if (end == text + 2 || *end != '\0' || number < 1 || number > NROWS) return false;
+
+    *x = letter - 'A' + 1;
+    *y = number;
+    return true;
+}
+
+/**
+ * Report a bad script line on stderr
+ */
+static void script_error(const script_t* script, const char* message) {
+    fprintf(stderr, "%s:%d: %s\n", script->path, script->line, message);
+}
+
+// Open a script
+int script_open(script_t* script, const char* path) {
+    script->path = path;
+    script->line = 0;
+    script->file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    return script->file == NULL ? -1 : 0;
+}
+
+// Close a script (stdin is left open)
+void script_close(script_t* script) {
+    if (script->file != NULL && script->file != stdin) fclose(script->file);
+    script->file = NULL;
+}
+
+// Read the fleet placement from a script and place it on a board
+int script_read_fleet(script_t* script, board_t* board) {
+    initBoard(board);
+
+    char buffer[SCRIPT_LINE_MAX];
+    char* line = next_line(script, buffer);
+
+    // "random", optionally followed by a seed, places the whole fleet at random
+    if (line != NULL && strncasecmp(line, "random", 6) == 0 &&
+        (line[6] == '\0' || isspace((unsigned char)line[6]))) {
+        char* end;
+        uint64_t seed = strtoull(line + 6, &end, 10);
+        while (isspace((unsigned char)*end)) end++;
+        if (*end != '\0') {
+            script_error(script, "expected \"random\" or \"random SEED\"");
+            return -1;
+        }
+        if (end == line + 6) seed = ((uint64_t)time(NULL) << 20) ^ getpid();
+
+        rng_t rng;
+        rng_seed(&rng, seed);
+        board_random_fleet(board, &rng);
+        return 0;
+    }
+
+    for (int i = 0; i < NDIFSHIPS; i++) {
+        if (i > 0) line = next_line(script, buffer);
+        if (line == NULL) {
+            script_error(script, "script ends before the whole fleet is placed");
+            return -1;
+        }
+
+        // Orientation, whitespace, then the start cell
+        shipLocation_t proposal = {.shipType = shipArray[i], .orientation = INVALID, .sunk = false};
+        char ort = toupper((unsigned char)line[0]);
+        if (ort == 'H') proposal.orientation = HORIZONTAL;
+        if (ort == 'V') proposal.orientation = VERTICAL;
+        char* cell = line + 1;
+        while (isspace((unsigned char)*cell)) cell++;
+        if (proposal.orientation == INVALID || cell == line + 1 ||
+            !parse_cell(cell, &proposal.startx, &proposal.starty)) {
+            script_error(script, "expected a placement like \"H A,1\"");
+            return -1;
+        }
+
+        const placement_t* placement = placement_find(proposal);
+        if (placement == NULL) {
+            script_error(script, "ship crosses the edge of the board");
+            return -1;
+        }
+        if (!placement_fits(board, placement)) {
+            script_error(script, "ship overlaps another ship");
+            return -1;
+        }
+        board_place(board, i, placement);
+    }
+    return 0;
+}
+
+// Read the next attack from a script
+bool script_next_attack(script_t* script, int* x, int* y, int* player) {
+    char buffer[SCRIPT_LINE_MAX];
+    char* line = next_line(script, buffer);
+    if (line == NULL) return false;
+    if (strcasecmp(line, "Q") == 0) return false;
+
+    // An optional P<number> names the player to attack
+    *player = 0;
+    if (toupper((unsigned char)line[0]) == 'P') {
+        char* end;
+        long number = strtol(line + 1, &end, 10);
+        if (end == line + 1 || !isspace((unsigned char)*end) || number < 1 || number > MAX_SEATS) {
+            script_error(script, "expected an attack like \"P2 A,1\"");
+            return false;
+        }
+        *player = number;
+        line = end;
+        while (isspace((unsigned char)*line)) line++;
+    }
+
+    if (!parse_cell(line, x, y)) {
+        script_error(script, "expected an attack like \"A,1\"");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+/**
+ * Scripted players - fleet placements and attacks read from a file (or stdin) instead of the
+ * keyboard, so a match can be replayed or load-tested at machine speed with no terminal.
+ *
+ * A script is plain text, one entry per line. Blank lines and lines starting with '#' are
+ * skipped. The first NDIFSHIPS entries place the fleet, in shipArray order (Destroyer first in the
+ * classic rules):
+ *
+ *   H A,1       orientation (H or V), then the start cell as LETTER,NUMBER
+ *
+ * or a single entry places the whole fleet at random instead (the same seed gives the same fleet):
+ *
+ *   random [SEED]
+ *
+ * Every entry after that is one attack, in the same LETTER,NUMBER format the prompts use (A,1
+ * through J,10 on the classic board). A line reading Q leaves the match, as does running out of attacks.
+ * In a match with more than two players an attack can name its target first:
+ *
+ *   P3 B,7      attack Player 3 (an attack without a P shoots at the next player still in)
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "board.h"
+
+/**
+ * script struct, stores an open script and where we are in it
+ */
+typedef struct script {
+    FILE* file;
+    const char* path;   // for error messages ("-" is stdin)
+    int line;           // number of the last line read
+} script_t;
+
+/**
+ * Open a script
+ *
+ * @param script The script to set up
+ * @param path   File to read, or "-" for stdin
+ * @return 0 on success, -1 with errno set on failure
+ */
+int script_open(script_t* script, const char* path);
+
+/**
+ * Close a script (stdin is left open)
+ *
+ * @param script The script
+ */
+void script_close(script_t* script);
+
+/**
+ * Read the fleet placement from a script and place it on a board
+ *
+ * @param script The script, positioned at its start
+ * @param board  The board to fill in (it is reset first)
+ * @return 0 on success, -1 (after printing the offending line to stderr) if a placement is
+ *         malformed, off the board, overlapping, or missing
+ */
+int script_read_fleet(script_t* script, board_t* board);
+
+/**
+ * Read the next attack from a script
+ *
+ * @param script The script, positioned after the fleet
+ * @param x      Set to the column, 1..NCOLS
+ * @param y      Set to the row, 1..NROWS
+ * @param player Set to the player the attack names (1 is Player 1), or 0 if it names none
+ * @return true if there is an attack to make, false if the player leaves the match (a Q line,
+ *         the end of the script, or a malformed line, which is reported on stderr)
+ */
+bool script_next_attack(script_t* script, int* x, int* y, int* player);
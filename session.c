@@ -0,0 +1,86 @@
+#include "session.h"
+
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * Read the monotonic clock
+ *
+ * @return The time in nanoseconds
+ */
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Start a session on a connected socket
+void session_init(session_t* session, int fd, int seat) {
+    msg_conn_init(&session->conn, fd);
+    session->state = SESSION_CONNECTED;
+    session->seat = seat;
+    session->players = 2;
+    session->connected_ns = now_ns();
+    session->playing_ns = session->first_turn_ns = session->over_ns = session->closed_ns = 0;
+}
+
+// Tell the other end our fleet is placed
+int session_ready(session_t* session, int peer_seat) {
+    frame_t ready = {.type = MSG_READY, .seat = peer_seat, .ship = NO_SHIP};
+    if (send_frame(session->conn.fd, &ready) == -1) {
+        session_over(session);
+        return -1;
+    }
+    session->state = SESSION_PLACED;
+    return 0;
+}
+
+// Wait for the other end's READY
+int session_wait_start(session_t* session, bool assign_seat) {
+    frame_t ready;
+    if (receive_frame(&session->conn, &ready) == -1 || ready.type != MSG_READY) {
+        session_over(session);
+        return -1;
+    }
+    if (assign_seat) {
+        session->seat = ready.seat;
+        if (ready.target != 0) session->players = ready.target;
+    }
+    session->state = SESSION_PLAYING;
+    session->playing_ns = now_ns();
+    return 0;
+}
+
+// Note that an attack was sent or received
+void session_turn(session_t* session) {
+    if (session->first_turn_ns == 0) session->first_turn_ns = now_ns();
+}
+
+// End the match
+void session_over(session_t* session) {
+    if (session->state >= SESSION_OVER) return;
+    session->state = SESSION_OVER;
+    session->over_ns = now_ns();
+}
+
+// Close the socket, ending the match first if needed
+void session_close(session_t* session) {
+    if (session->state == SESSION_CLOSED) return;
+    session_over(session);
+    close(session->conn.fd);
+    session->state = SESSION_CLOSED;
+    session->closed_ns = now_ns();
+}
+
+// Print how long start-up and tear-down took
+void session_print_timing(const session_t* session, FILE* out) {
+    if (session->first_turn_ns != 0) {
+        fprintf(out, "Time to first turn: %.3f ms (both ready after %.3f ms)\n",
+                (session->first_turn_ns - session->connected_ns) / 1e6,
+                (session->playing_ns - session->connected_ns) / 1e6);
+    }
+    if (session->closed_ns != 0) {
+        fprintf(out, "Time to teardown: %.3f ms\n", (session->closed_ns - session->over_ns) / 1e6);
+    }
+}
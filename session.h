@@ -0,0 +1,102 @@
+/**
+ * One player's side of a match connection, as an explicit state machine:
+ *
+ *   CONNECTED --session_ready--> PLACED --opponent's READY--> PLAYING --last ship, QUIT,
+ *   or a dropped connection--> OVER --session_close--> CLOSED
+ *
+ * Every transition is driven by a frame we send or receive (or the connection failing), never
+ * by a timer, and the time of each one is recorded so the start-up and shut-down paths can be
+ * measured.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "gameMessage.h"
+#include "protocol.h"
+
+//where a connection is in its match
+typedef enum session_state {
+    SESSION_CONNECTED,  // socket up, fleet not placed yet
+    SESSION_PLACED,     // our READY is sent, waiting for the opponent's (or the host's)
+    SESSION_PLAYING,    // taking turns
+    SESSION_OVER,       // somebody won, somebody quit, or the connection dropped
+    SESSION_CLOSED      // the socket is closed
+} session_state_t;
+
+/**
+ * session struct, stores a match connection, our seat, and when each state was reached
+ */
+typedef struct session {
+    msg_conn_t conn;
+    session_state_t state;
+    int seat;                   // 0 shoots first
+    int players;                // seats in the match (more than two: a free-for-all, see protocol.h)
+    uint64_t connected_ns;      // CLOCK_MONOTONIC time the socket came up
+    uint64_t playing_ns;        // ... both players were ready
+    uint64_t first_turn_ns;     // ... the first attack was sent or received
+    uint64_t over_ns;           // ... the match ended
+    uint64_t closed_ns;         // ... the socket was closed
+} session_t;
+
+/**
+ * Start a session on a connected socket
+ *
+ * @param session The session to set up
+ * @param fd      The connected socket
+ * @param seat    Our seat, if we already know it (the host or server tells a client in its READY)
+ */
+void session_init(session_t* session, int fd, int seat);
+
+/**
+ * Tell the other end our fleet is placed (CONNECTED -> PLACED)
+ *
+ * @param session   The session
+ * @param peer_seat Seat the receiver gets, when we're the one handing out seats
+ * @return 0 on success, -1 if the connection failed (the session is then OVER)
+ */
+int session_ready(session_t* session, int peer_seat);
+
+/**
+ * Wait for the other end's READY (PLACED -> PLAYING)
+ *
+ * @param session     The session
+ * @param assign_seat true to take our seat and the number of seats from the READY (clients),
+ *                    false to keep ours (server)
+ * @return 0 once the match is on, -1 if the opponent quit, the connection dropped, or something
+ *         other than READY arrived (the session is then OVER)
+ */
+int session_wait_start(session_t* session, bool assign_seat);
+
+/**
+ * Note that an attack was sent or received; the first one marks the time to first turn
+ *
+ * @param session The session
+ */
+void session_turn(session_t* session);
+
+/**
+ * End the match (PLAYING -> OVER). Does nothing if it already ended.
+ *
+ * @param session The session
+ */
+void session_over(session_t* session);
+
+/**
+ * Close the socket (-> CLOSED), ending the match first if needed
+ *
+ * @param session The session
+ */
+void session_close(session_t* session);
+
+/**
+ * Print how long start-up (connection to first turn) and tear-down (end of the match to the
+ * socket closing) took
+ *
+ * @param session A closed session
+ * @param out     Where to print
+ */
+void session_print_timing(const session_t* session, FILE* out);
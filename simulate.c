@@ -0,0 +1,561 @@
+/**
+ * Self-play simulator - plays huge numbers of headless games between two shooting strategies on
+ * every core, for judging AI changes by their statistics rather than by a handful of games.
+ *
+ * A player's shots never depend on what the opponent does, so a game is played as two solo runs:
+ * each strategy shoots at a fresh random fleet until it is sunk, and whichever needed fewer shots
+ * wins (on a tie the player who shot first wins, and the first shot alternates from game to game).
+ * That gives every game's shots-to-win for both strategies, not just the winner's.
+ *
+ * Each thread plays its share of the games with its own random numbers (seeded from the run's seed
+ * and its thread number) and its own tallies, and nothing is shared until the threads are joined,
+ * so a seed and thread count always replay the same games. Results are printed as JSON: games per
+ * second, each strategy's shots-to-win distribution (mean, deviation, percentiles, and the full
+ * histogram), and how often the first strategy won.
+ *
+ * Strategies: random, hunt (parity hunting, then the neighbours of hits), heatmap (ai.h), and
+ * montecarlo (montecarlo.h, one sampling thread per simulator thread).
+ *
+ * With -S the games are played on massive sparse boards (sparse.h) instead, from 1000x1000 up to
+ * 100000x100000, each with a fleet of -f ships (the ruleset's ships over and over). Only random and
+ * hunt play there. A run stops after -x shots, or once half the board has been shot at, so most
+ * runs end without sinking the whole fleet: a player who sank the fleet beats one who didn't, then
+ * fewer shots win if both did and more ships sunk if neither did. Results give each strategy's mean
+ * shots and ships sunk, how many fleets it sank, and the guesses per second.
+ *
+ * Usage: battleship-sim [-a strategy] [-b strategy] [-g games] [-t threads] [-s seed] [-m mc-microseconds]
+ *                       [-S rows[xcols] [-f ships] [-x shot-limit]]
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ai.h"
+#include "board.h"
+#include "montecarlo.h"
+#include "placement.h"
+#include "sparse.h"
+
+#define SPARSE_GAMES 16         // default number of games on sparse boards
+#define PARITY_TRIES 64         // random cells tried for one of the hunt's checkerboard before taking any cell
+
+/**
+ * shooter struct, stores one strategy's state during a solo run
+ */
+typedef struct shooter {
+    ai_t ai;            // hits, misses, and sunk ships so far, and the shooter's random numbers
+    mc_pool_t* pool;    // sampling thread, for montecarlo
+} shooter_t;
+
+/**
+ * sparse_shooter struct, stores one strategy's state during a solo run on a sparse board
+ */
+typedef struct sparse_shooter {
+    rng_t rng;
+    const sparse_board_t* board;    // the board being shot at, for the cells already guessed
+    uint64_t* targets;              // neighbours of hits, as y << 32 | x (some may have been shot at since)
+    size_t targetCount;
+    size_t targetCapacity;
+} sparse_shooter_t;
+
+/**
+ * strategy struct, stores a way of picking shots
+ */
+typedef struct strategy {
+    const char* name;
+    void (*shoot)(shooter_t* shooter, int* x, int* y);
+    void (*sparse_shoot)(sparse_shooter_t* shooter, uint32_t* x, uint32_t* y);  // NULL if it can't play sparse boards
+} strategy_t;
+
+/**
+ * worker struct, stores one thread's share of the games and what it tallied
+ */
+typedef struct worker {
+    pthread_t thread;
+    uint64_t seed;
+    long games;
+    long wins;                                  // games the first strategy won
+    unsigned long shots[2][BB_CELLS + 1];       // per strategy: games that took each number of shots
+    uint64_t sparseShots[2];                    // per strategy, on sparse boards: shots in all games,
+    uint64_t sparseSunk[2];                     // ships sunk in all games,
+    long sparseFleets[2];                       // and games it sank the whole fleet in
+    const char* error;                          // why the thread stopped early, or NULL
+} worker_t;
+
+//settings, fixed before any thread starts
+static const strategy_t* strategies[2];
+static uint64_t mc_budget_ns = 1000000;
+static uint32_t sparse_rows, sparse_cols;       // size of the sparse boards, 0 to play the dense board
+static uint32_t sparse_ships = 500;
+static uint32_t* sparse_sizes;
+static uint64_t sparse_shot_limit = 1000000;
+
+//cell masks for the strategies that look at neighbours and parity, built before any thread starts
+static bitboard_t not_first_col, not_last_col, parity;
+
+/**
+ * Read the monotonic clock
+ *
+ * @return The time in nanoseconds
+ */
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Pick one of a set of cells at random
+ */
+static void pick(shooter_t* shooter, bitboard_t cells, int* x, int* y) {
+    int cell = bb_select(cells, rng_below(&shooter->ai.rng, bb_count(cells)));
+    *x = cell % NCOLS + 1;
+    *y = cell / NCOLS + 1;
+}
+
+// random: any cell not shot at yet
+static void shoot_random(shooter_t* shooter, int* x, int* y) {
+    pick(shooter, bb_andnot(bb_all(), shooter->ai.guessed), x, y);
+}
+
+// hunt: the neighbours of hits not yet known to be sunk, otherwise every other cell (the smallest
+// ship is 2 long, so a checkerboard finds every ship)
+static void shoot_hunt(shooter_t* shooter, int* x, int* y) {
+    const ai_t* ai = &shooter->ai;
+    bitboard_t unguessed = bb_andnot(bb_all(), ai->guessed);
+    bitboard_t open = bb_andnot(ai->hit, ai->sunk);
+
+    bitboard_t next = bb_or(bb_and(bb_shr(open, 1), not_last_col), bb_and(bb_shl(open, 1), not_first_col));
+    next = bb_or(next, bb_or(bb_shr(open, NCOLS), bb_shl(open, NCOLS)));
+    next = bb_and(next, unguessed);
+    if (bb_empty(next)) next = bb_and(parity, unguessed);
+    if (bb_empty(next)) next = unguessed;
+    pick(shooter, next, x, y);
+}
+
+// heatmap: the probability-density AI
+static void shoot_heatmap(shooter_t* shooter, int* x, int* y) {
+    ai_choose_shot(&shooter->ai, x, y);
+}
+
+// montecarlo: the sampling AI, with mc_budget_ns per shot
+static void shoot_montecarlo(shooter_t* shooter, int* x, int* y) {
+    mc_choose_shot(shooter->pool, &shooter->ai, mc_budget_ns, x, y);
+}
+
+/**
+ * Pick a sparse board cell not shot at yet. The shot limit leaves at least half the board unshot,
+ * so that takes two random cells on average.
+ *
+ * @param checkerboard Prefer cells with x + y even
+ */
+static void sparse_pick(sparse_shooter_t* shooter, bool checkerboard, uint32_t* x, uint32_t* y) {
+    const sparse_board_t* board = shooter->board;
+    for (int tries = 0;; tries++) {
+        *x = rng_below(&shooter->rng, board->cols) + 1;
+        *y = rng_below(&shooter->rng, board->rows) + 1;
+        if (checkerboard && tries < PARITY_TRIES && (*x + *y) % 2 != 0) continue;
+        if (!sparse_guessed(board, *x, *y)) return;
+    }
+}
+
+// random on a sparse board: any cell not shot at yet
+static void sparse_shoot_random(sparse_shooter_t* shooter, uint32_t* x, uint32_t* y) {
+    sparse_pick(shooter, false, x, y);
+}
+
+// hunt on a sparse board: the neighbours of hits, otherwise every other cell
+static void sparse_shoot_hunt(sparse_shooter_t* shooter, uint32_t* x, uint32_t* y) {
+    while (shooter->targetCount > 0) {
+        uint64_t cell = shooter->targets[--shooter->targetCount];
+        *x = (uint32_t)cell;
+        *y = cell >> 32;
+        if (!sparse_guessed(shooter->board, *x, *y)) return;
+    }
+    sparse_pick(shooter, true, x, y);
+}
+
+/**
+ * Remember the neighbours of a hit that are on the board and not shot at yet
+ *
+ * @return 0 on success, -1 if memory ran out
+ */
+static int sparse_record_hit(sparse_shooter_t* shooter, uint32_t x, uint32_t y) {
+    const sparse_board_t* board = shooter->board;
+    const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+    for (int d = 0; d < 4; d++) {
+        uint32_t nx = x + dx[d], ny = y + dy[d];
+        if (nx < 1 || nx > board->cols || ny < 1 || ny > board->rows || sparse_guessed(board, nx, ny)) continue;
+        if (shooter->targetCount == shooter->targetCapacity) {
+            size_t capacity = shooter->targetCapacity == 0 ? 64 : shooter->targetCapacity * 2;
+            uint64_t* targets = realloc(shooter->targets, capacity * sizeof(uint64_t));
+            if (targets == NULL) return -1;
+            shooter->targets = targets;
+            shooter->targetCapacity = capacity;
+        }
+        shooter->targets[shooter->targetCount++] = (uint64_t)ny << 32 | nx;
+    }
+    return 0;
+}
+
+static const strategy_t all_strategies[] = {
+    {"random", shoot_random, sparse_shoot_random},
+    {"hunt", shoot_hunt, sparse_shoot_hunt},
+    {"heatmap", shoot_heatmap, NULL},
+    {"montecarlo", shoot_montecarlo, NULL},
+};
+
+/**
+ * Look up a strategy by name
+ *
+ * @return The strategy, or NULL if there's none by that name
+ */
+static const strategy_t* find_strategy(const char* name) {
+    for (size_t i = 0; i < sizeof(all_strategies) / sizeof(all_strategies[0]); i++) {
+        if (strcmp(all_strategies[i].name, name) == 0) return &all_strategies[i];
+    }
+    return NULL;
+}
+
+/**
+ * Let a strategy shoot at a fleet until it's sunk
+ *
+ * @param strategy The strategy
+ * @param shooter  Its state (reset here)
+ * @param fleet    The fleet to sink
+ * @param seed     Seed for the strategy's random numbers
+ * @return The number of shots it took
+ */
+static int shots_to_win(const strategy_t* strategy, shooter_t* shooter, board_t* fleet, uint64_t seed) {
+    ai_init(&shooter->ai, seed);
+    int shots = 0;
+    while (fleet->shipsSunk < NDIFSHIPS && shots < BB_CELLS) {
+        int x, y;
+        strategy->shoot(shooter, &x, &y);
+        guess_result_t result = board_guess(fleet, x, y);
+        ai_record_shot(&shooter->ai, x, y, result, result == GUESS_SUNK ? board_ship_at(fleet, x, y) : NO_SHIP_INDEX);
+        shots++;
+    }
+    return shots;
+}
+
+/**
+ * Let a strategy shoot at a sparse fleet until it's sunk or the shot limit is reached
+ *
+ * @param strategy The strategy
+ * @param shooter  Its state (reset here)
+ * @param fleet    The fleet to sink
+ * @param seed     Seed for the strategy's random numbers
+ * @return 0 on success, -1 if memory ran out
+ */
+static int sparse_shots_to_win(const strategy_t* strategy, sparse_shooter_t* shooter, sparse_board_t* fleet,
+                               uint64_t seed) {
+    rng_seed(&shooter->rng, seed);
+    shooter->board = fleet;
+    shooter->targetCount = 0;
+
+    // At most half the board, so there are always unshot cells close at hand
+    uint64_t limit = ((uint64_t)fleet->rows * fleet->cols + 1) / 2;
+    if (limit > sparse_shot_limit) limit = sparse_shot_limit;
+    while (!sparse_victory(fleet) && fleet->shotCount < limit) {
+        uint32_t x, y;
+        strategy->sparse_shoot(shooter, &x, &y);
+        guess_result_t result = sparse_guess(fleet, x, y, NULL);
+        if (result == GUESS_INVALID) return -1;
+        if ((result == GUESS_HIT || result == GUESS_SUNK) && sparse_record_hit(shooter, x, y) == -1) return -1;
+    }
+    return 0;
+}
+
+/**
+ * A simulator thread on sparse boards: play this worker's games
+ */
+static void sparse_worker_main(worker_t* worker, rng_t* rng) {
+    sparse_shooter_t shooters[2] = {{.targets = NULL}, {.targets = NULL}};
+    for (long g = 0; g < worker->games && worker->error == NULL; g++) {
+        uint64_t shots[2];
+        uint32_t sunk[2];
+        bool fleet_sunk[2];
+        for (int s = 0; s < 2; s++) {
+            sparse_board_t fleet;
+            if (sparse_board_init(&fleet, sparse_rows, sparse_cols) == -1) {
+                worker->error = "Out of memory";
+                break;
+            }
+            if (sparse_random_fleet(&fleet, sparse_sizes, sparse_ships, rng) == -1) {
+                worker->error = "The fleet doesn't fit on the board";
+            } else if (sparse_shots_to_win(strategies[s], &shooters[s], &fleet, rng_next(rng)) == -1) {
+                worker->error = "Out of memory";
+            }
+            shots[s] = fleet.shotCount;
+            sunk[s] = fleet.shipsSunk;
+            fleet_sunk[s] = sparse_victory(&fleet);
+            sparse_board_free(&fleet);
+            if (worker->error != NULL) break;
+
+            worker->sparseShots[s] += shots[s];
+            worker->sparseSunk[s] += sunk[s];
+            worker->sparseFleets[s] += fleet_sunk[s];
+        }
+        if (worker->error != NULL) break;
+
+        bool a_first = g % 2 == 0;
+        bool a_wins;
+        if (fleet_sunk[0] != fleet_sunk[1]) {
+            a_wins = fleet_sunk[0];
+        } else if (fleet_sunk[0] ? shots[0] != shots[1] : sunk[0] != sunk[1]) {
+            a_wins = fleet_sunk[0] ? shots[0] < shots[1] : sunk[0] > sunk[1];
+        } else {
+            a_wins = a_first;
+        }
+        worker->wins += a_wins;
+    }
+
+    for (int s = 0; s < 2; s++) free(shooters[s].targets);
+}
+
+/**
+ * A simulator thread: play this worker's games
+ */
+static void* worker_main(void* arg) {
+    worker_t* worker = arg;
+    rng_t rng;
+    rng_seed(&rng, worker->seed);
+    if (sparse_rows != 0) {
+        sparse_worker_main(worker, &rng);
+        return NULL;
+    }
+
+    shooter_t shooters[2] = {{.pool = NULL}, {.pool = NULL}};
+    for (int s = 0; s < 2 && worker->error == NULL; s++) {
+        if (strategies[s]->shoot != shoot_montecarlo) continue;
+        shooters[s].pool = mc_pool_create(1, rng_next(&rng));
+        if (shooters[s].pool == NULL) worker->error = "Failed to start a Monte Carlo sampling thread";
+    }
+
+    for (long g = 0; g < worker->games && worker->error == NULL; g++) {
+        int shots[2];
+        for (int s = 0; s < 2; s++) {
+            board_t fleet;
+            board_random_fleet(&fleet, &rng);
+            shots[s] = shots_to_win(strategies[s], &shooters[s], &fleet, rng_next(&rng));
+            worker->shots[s][shots[s]]++;
+        }
+        bool a_first = g % 2 == 0;
+        if (shots[0] < shots[1] || (shots[0] == shots[1] && a_first)) worker->wins++;
+    }
+
+    for (int s = 0; s < 2; s++) {
+        if (shooters[s].pool != NULL) mc_pool_destroy(shooters[s].pool);
+    }
+    return NULL;
+}
+
+/**
+ * Find the smallest shot count that at least a fraction q of the games needed no more than
+ */
+static int percentile(const unsigned long* histogram, long games, double q) {
+    unsigned long seen = 0;
+    for (int n = 0; n <= BB_CELLS; n++) {
+        seen += histogram[n];
+        if (seen >= q * games) return n;
+    }
+    return BB_CELLS;
+}
+
+/**
+ * Print one strategy's shots-to-win distribution as a JSON object
+ */
+static void print_distribution(const char* name, const unsigned long* histogram, long games, bool last) {
+    double sum = 0, squares = 0;
+    int min = -1, max = 0;
+    for (int n = 0; n <= BB_CELLS; n++) {
+        if (histogram[n] == 0) continue;
+        if (min == -1) min = n;
+        max = n;
+        sum += (double)n * histogram[n];
+        squares += (double)n * n * histogram[n];
+    }
+    double mean = sum / games;
+    double stdev = sqrt(squares / games - mean * mean);
+
+    printf("    {\"strategy\": \"%s\", \"mean\": %.3f, \"stdev\": %.3f, \"stderr\": %.4f,\n", name, mean, stdev,
+           stdev / sqrt(games));
+    printf("     \"min\": %d, \"p10\": %d, \"p50\": %d, \"p90\": %d, \"p99\": %d, \"max\": %d,\n", min,
+           percentile(histogram, games, 0.1), percentile(histogram, games, 0.5), percentile(histogram, games, 0.9),
+           percentile(histogram, games, 0.99), max);
+    printf("     \"histogram\": {");
+    bool first = true;
+    for (int n = 0; n <= BB_CELLS; n++) {
+        if (histogram[n] == 0) continue;
+        printf("%s\"%d\": %lu", first ? "" : ", ", n, histogram[n]);
+        first = false;
+    }
+    printf("}}%s\n", last ? "" : ",");
+}
+
+int main(int argc, char* argv[]) {
+    const char* names[2] = {NULL, NULL};
+    long games = 0;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = cores > 0 ? cores : 1;
+    uint64_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "a:b:g:t:s:m:S:f:x:")) != -1) {
+        switch (opt) {
+            case 'a': names[0] = optarg; break;
+            case 'b': names[1] = optarg; break;
+            case 'g': games = atol(optarg); break;
+            case 't': threads = atoi(optarg); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 'm': mc_budget_ns = strtoull(optarg, NULL, 10) * 1000; break;
+            case 'S': {
+                char* end;
+                unsigned long rows = strtoul(optarg, &end, 10);
+                unsigned long cols = *end == 'x' ? strtoul(end + 1, &end, 10) : rows;
+                if (*end != '\0' || rows < 1 || rows > SPARSE_MAX_SIDE || cols < 1 || cols > SPARSE_MAX_SIDE) {
+                    fprintf(stderr, "Sparse boards are 1 to %d rows and columns (-S rows or -S rowsxcols)\n",
+                            SPARSE_MAX_SIDE);
+                    exit(EXIT_FAILURE);
+                }
+                sparse_rows = rows;
+                sparse_cols = cols;
+                break;
+            }
+            case 'f': sparse_ships = strtoul(optarg, NULL, 10); break;
+            case 'x': sparse_shot_limit = strtoull(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "Usage: %s [-a strategy] [-b strategy] [-g games] [-t threads] [-s seed] "
+                        "[-m mc-microseconds] [-S rows[xcols] [-f ships] [-x shot-limit]]\n", argv[0]);
+                fprintf(stderr, "Strategies: random, hunt, heatmap, montecarlo\n");
+                exit(EXIT_FAILURE);
+        }
+    }
+    // heatmap against hunt, or on sparse boards hunt against random
+    if (names[0] == NULL) names[0] = sparse_rows != 0 ? "hunt" : "heatmap";
+    if (names[1] == NULL) names[1] = sparse_rows != 0 ? "random" : "hunt";
+    for (int s = 0; s < 2; s++) {
+        strategies[s] = find_strategy(names[s]);
+        if (strategies[s] == NULL) {
+            fprintf(stderr, "Unknown strategy %s (use random, hunt, heatmap, or montecarlo)\n", names[s]);
+            exit(EXIT_FAILURE);
+        }
+        if (sparse_rows != 0 && strategies[s]->sparse_shoot == NULL) {
+            fprintf(stderr, "Strategy %s doesn't play sparse boards (use random or hunt with -S)\n", names[s]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (games == 0) games = sparse_rows != 0 ? SPARSE_GAMES : 100000;
+    if (sparse_rows != 0 && (sparse_ships < 1 || sparse_shot_limit < 1)) {
+        fprintf(stderr, "Need at least one ship and one shot\n");
+        exit(EXIT_FAILURE);
+    }
+    if (games < 1 || threads < 1) {
+        fprintf(stderr, "Need at least one game and one thread\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int y = 1; y <= NROWS; y++) {
+        for (int x = 1; x <= NCOLS; x++) {
+            if (x != 1) bb_set(&not_first_col, x, y);
+            if (x != NCOLS) bb_set(&not_last_col, x, y);
+            if ((x + y) % 2 == 0) bb_set(&parity, x, y);
+        }
+    }
+
+    // The sparse fleet is the ruleset's ships over and over
+    if (sparse_rows != 0) {
+        sparse_sizes = malloc(sparse_ships * sizeof(uint32_t));
+        if (sparse_sizes == NULL) {
+            perror("Failed to allocate the fleet");
+            exit(EXIT_FAILURE);
+        }
+        for (uint32_t i = 0; i < sparse_ships; i++) sparse_sizes[i] = shipArray[i % NDIFSHIPS].size;
+    }
+
+    worker_t* workers = calloc(threads, sizeof(worker_t));
+    if (workers == NULL) {
+        perror("Failed to allocate workers");
+        exit(EXIT_FAILURE);
+    }
+    uint64_t start = now_ns();
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t].seed = seed * 0x9E3779B97F4A7C15ull + t;
+        workers[t].games = games / threads + (t < games % threads);
+        if (pthread_create(&workers[t].thread, NULL, worker_main, &workers[t]) != 0) break;
+        started++;
+    }
+    if (started == 0) {
+        fprintf(stderr, "Failed to start any simulator threads\n");
+        exit(EXIT_FAILURE);
+    }
+    if (started < threads) {
+        // Carry on with the threads that did start; only their games are played (and reported)
+        fprintf(stderr, "Only started %d of %d simulator threads\n", started, threads);
+        threads = started;
+        games = 0;
+        for (int t = 0; t < threads; t++) games += workers[t].games;
+    }
+
+    long wins = 0;
+    unsigned long shots[2][BB_CELLS + 1] = {{0}};
+    uint64_t sparse_shots[2] = {0}, sparse_sunk[2] = {0};
+    long sparse_fleets[2] = {0};
+    const char* error = NULL;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+        wins += workers[t].wins;
+        for (int s = 0; s < 2; s++) {
+            for (int n = 0; n <= BB_CELLS; n++) shots[s][n] += workers[t].shots[s][n];
+            sparse_shots[s] += workers[t].sparseShots[s];
+            sparse_sunk[s] += workers[t].sparseSunk[s];
+            sparse_fleets[s] += workers[t].sparseFleets[s];
+        }
+        if (workers[t].error != NULL) error = workers[t].error;
+    }
+    double seconds = (now_ns() - start) / 1e9;
+    if (error != NULL && sparse_rows != 0) {
+        fprintf(stderr, "%s (%u ships on a %ux%u board)\n", error, sparse_ships, sparse_rows, sparse_cols);
+        exit(EXIT_FAILURE);
+    } else if (error != NULL) {
+        fprintf(stderr, "%s\n", error);
+        exit(EXIT_FAILURE);
+    }
+
+    double win_rate = (double)wins / games;
+    printf("{\n");
+    printf("  \"games\": %ld, \"threads\": %d, \"seed\": %llu, \"seconds\": %.3f, \"games_per_second\": %.1f,\n",
+           games, threads, (unsigned long long)seed, seconds, games / seconds);
+    printf("  \"a_win_rate\": %.4f, \"a_win_rate_95ci\": %.4f,\n", win_rate,
+           1.96 * sqrt(win_rate * (1 - win_rate) / games));
+    if (sparse_rows != 0) {
+        printf("  \"rows\": %u, \"cols\": %u, \"ships\": %u, \"shot_limit\": %llu, \"guesses_per_second\": %.0f,\n",
+               sparse_rows, sparse_cols, sparse_ships, (unsigned long long)sparse_shot_limit,
+               (sparse_shots[0] + sparse_shots[1]) / seconds);
+        printf("  \"results\": [\n");
+        for (int s = 0; s < 2; s++) {
+            printf("    {\"strategy\": \"%s\", \"mean_shots\": %.1f, \"mean_sunk\": %.2f, \"fleets_sunk\": %ld}%s\n",
+                   names[s], (double)sparse_shots[s] / games, (double)sparse_sunk[s] / games, sparse_fleets[s],
+                   s == 0 ? "," : "");
+        }
+    } else {
+        printf("  \"shots_to_win\": [\n");
+        print_distribution(names[0], shots[0], games, false);
+        print_distribution(names[1], shots[1], games, true);
+    }
+    printf("  ]\n");
+    printf("}\n");
+
+    free(workers);
+    free(sparse_sizes);
+    return 0;
+}
@@ -16,7 +16,7 @@
  * \returns   A file descriptor for the connected socket, or -1 if there is an
  *            error. The errno value will be set by the failed POSIX call.
  */
-static int socket_connect(char* server_name, unsigned short port) {
+static inline int socket_connect(char* server_name, unsigned short port) {
   // Look up the server by name
   struct hostent* server = gethostbyname(server_name);
   if (server == NULL) {
@@ -62,7 +62,7 @@ static int socket_connect(char* server_name, unsigned short port) {
  *                In case of failure, this function returns -1. The value of
  *                errno will be set by the POSIX socket function that failed.
  */
-static int server_socket_open(unsigned short* port) {
+static inline int server_socket_open(unsigned short* port) {
   // Create a server socket. Return if there is an error.
   int fd = socket(AF_INET, SOCK_STREAM, 0);
   if (fd == -1) {
@@ -112,7 +112,7 @@ static int server_socket_open(unsigned short* port) {
  * \returns   The file descriptor for the newly-connected client socket. In case
  *            of failure, returns -1 with errno set by the failed accept call.
  */
-static int server_socket_accept(int server_socket_fd) {
+static inline int server_socket_accept(int server_socket_fd) {
   // Create a struct to record the connected client's address
   struct sockaddr_in client_addr;
   socklen_t client_addr_len = sizeof(struct sockaddr_in);
@@ -0,0 +1,288 @@
+#include "sparse.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SPARSE_FIRST_SHIPS 16       // ship slots allocated by the first placement
+#define SPARSE_FIRST_SHOTS 64       // shot slots allocated up front (a power of two)
+#define SPARSE_PLACE_TRIES 1000     // random positions tried per ship before giving up
+
+/**
+ * Build a spatial index key
+ *
+ * @param line The row of a horizontal ship, or the column of a vertical one
+ * @param pos  The cell along the line
+ * @return The key
+ */
+static inline uint64_t span_key(uint32_t line, uint32_t pos) {
+    return (uint64_t)line << 32 | pos;
+}
+
+/**
+ * Find the first span whose key is greater than key (binary search)
+ *
+ * @param spans The spans, sorted by key
+ * @param count Number of spans
+ * @param key   The key to look for
+ * @return Its position, 0..count
+ */
+static uint32_t span_after(const sparse_span_t* spans, uint32_t count, uint64_t key) {
+    if (count == 0) return 0;
+    // Halve the range without branching on the comparison (it's a coin flip, so a branch would
+    // mispredict half the time); the answer stays within base..base + len
+    const sparse_span_t* base = spans;
+    uint32_t len = count;
+    while (len > 1) {
+        uint32_t half = len / 2;
+        base += (base[half - 1].key <= key) * half;
+        len -= half;
+    }
+    return (base - spans) + (base->key <= key);
+}
+
+/**
+ * Find the span covering a cell. Spans on a line never overlap, so it can only be the last one
+ * starting at or before the cell.
+ *
+ * @param spans The spans, sorted by key
+ * @param count Number of spans
+ * @param line  The row (or column) of the cell
+ * @param pos   The cell along the line
+ * @return The span, or NULL if none covers the cell
+ */
+static const sparse_span_t* span_at(const sparse_span_t* spans, uint32_t count, uint32_t line, uint32_t pos) {
+    uint32_t i = span_after(spans, count, span_key(line, pos));
+    if (i == 0) return NULL;
+    const sparse_span_t* span = &spans[i - 1];
+    return span->key >> 32 == line && span->end >= pos ? span : NULL;
+}
+
+/**
+ * Check whether any span on a line overlaps the cells first..last of it
+ */
+static bool spans_overlap(const sparse_span_t* spans, uint32_t count, uint32_t line, uint32_t first, uint32_t last) {
+    // The last span starting at or before last is the only one that can reach back to first
+    uint32_t i = span_after(spans, count, span_key(line, last));
+    return i > 0 && spans[i - 1].key >> 32 == line && spans[i - 1].end >= first;
+}
+
+/**
+ * Check whether any span on the lines first..last crosses the cell pos of those lines
+ */
+static bool spans_cross(const sparse_span_t* spans, uint32_t count, uint32_t first, uint32_t last, uint32_t pos) {
+    // Walk the spans on those lines in order (lines start at 1, so the key before line first's is
+    // real); only ships near the new one are visited
+    for (uint32_t i = span_after(spans, count, span_key(first, 0) - 1); i < count; i++) {
+        uint32_t line = spans[i].key >> 32, start = spans[i].key & UINT32_MAX;
+        if (line > last) break;
+        if (line >= first && start <= pos && spans[i].end >= pos) return true;
+    }
+    return false;
+}
+
+/**
+ * Insert a span, keeping the spans sorted (there has to be room for one more)
+ */
+static void span_insert(sparse_span_t* spans, uint32_t* count, sparse_span_t span) {
+    uint32_t i = span_after(spans, *count, span.key);
+    memmove(&spans[i + 1], &spans[i], (*count - i) * sizeof(sparse_span_t));
+    spans[i] = span;
+    (*count)++;
+}
+
+/**
+ * Get the hash set slot to start probing at for a shot
+ */
+static inline uint64_t shot_slot(uint64_t key, uint64_t capacity) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    return (h ^ h >> 29) & (capacity - 1);
+}
+
+/**
+ * Get the hash set key of a cell (its cell number + 1, so 0 can mark an empty slot)
+ */
+static inline uint64_t shot_key(const sparse_board_t* board, uint32_t x, uint32_t y) {
+    return (uint64_t)(y - 1) * board->cols + x;
+}
+
+/**
+ * Add a key to a hash set that has room for it, unless it's already there
+ *
+ * @return true if it was added, false if it was already there
+ */
+static bool shots_add(uint64_t* shots, uint64_t capacity, uint64_t key) {
+    for (uint64_t slot = shot_slot(key, capacity);; slot = (slot + 1) & (capacity - 1)) {
+        if (shots[slot] == key) return false;
+        if (shots[slot] == 0) {
+            shots[slot] = key;
+            return true;
+        }
+    }
+}
+
+/**
+ * Double the hash set's slots once it's half full
+ *
+ * @return 0 on success, -1 if memory ran out
+ */
+static int shots_reserve(sparse_board_t* board) {
+    if ((board->shotCount + 1) * 2 <= board->shotCapacity) return 0;
+
+    uint64_t capacity = board->shotCapacity * 2;
+    uint64_t* shots = calloc(capacity, sizeof(uint64_t));
+    if (shots == NULL) return -1;
+    for (uint64_t i = 0; i < board->shotCapacity; i++) {
+        if (board->shots[i] != 0) shots_add(shots, capacity, board->shots[i]);
+    }
+    free(board->shots);
+    board->shots = shots;
+    board->shotCapacity = capacity;
+    return 0;
+}
+
+// Set up an empty sparse board
+int sparse_board_init(sparse_board_t* board, uint32_t rows, uint32_t cols) {
+    *board = (sparse_board_t){0};
+    if (rows < 1 || rows > SPARSE_MAX_SIDE || cols < 1 || cols > SPARSE_MAX_SIDE) return -1;
+    board->rows = rows;
+    board->cols = cols;
+    board->shots = calloc(SPARSE_FIRST_SHOTS, sizeof(uint64_t));
+    if (board->shots == NULL) return -1;
+    board->shotCapacity = SPARSE_FIRST_SHOTS;
+    return 0;
+}
+
+// Free everything a sparse board allocated
+void sparse_board_free(sparse_board_t* board) {
+    free(board->ships);
+    free(board->rowSpans);
+    free(board->colSpans);
+    free(board->shots);
+    *board = (sparse_board_t){0};
+}
+
+// Count the bytes a sparse board has allocated
+size_t sparse_board_bytes(const sparse_board_t* board) {
+    return board->shipCapacity * (sizeof(sparse_ship_t) + 2 * sizeof(sparse_span_t)) +
+           board->shotCapacity * sizeof(uint64_t);
+}
+
+// Find the ship on a cell
+int sparse_ship_at(const sparse_board_t* board, uint32_t x, uint32_t y) {
+    if (x < 1 || x > board->cols || y < 1 || y > board->rows) return NO_SHIP_INDEX;
+    const sparse_span_t* span = span_at(board->rowSpans, board->rowCount, y, x);
+    if (span == NULL) span = span_at(board->colSpans, board->colCount, x, y);
+    return span == NULL ? NO_SHIP_INDEX : (int)span->ship;
+}
+
+// Place a ship, if it stays on the board and misses every ship already placed
+int sparse_place(sparse_board_t* board, uint32_t x, uint32_t y, uint32_t size, enum Orientation orientation) {
+    bool vertical = orientation == VERTICAL;
+    if (orientation != HORIZONTAL && !vertical) return -1;
+    if (size < 1 || x < 1 || x > board->cols || y < 1 || y > board->rows) return -1;
+    if (vertical ? size > board->rows - y + 1 : size > board->cols - x + 1) return -1;
+
+    // A ship along a line can hit ships on the same line, or cross ships running the other way
+    uint32_t line = vertical ? x : y, first = vertical ? y : x, last = first + size - 1;
+    if (vertical) {
+        if (spans_overlap(board->colSpans, board->colCount, line, first, last)) return -1;
+        if (spans_cross(board->rowSpans, board->rowCount, first, last, line)) return -1;
+    } else {
+        if (spans_overlap(board->rowSpans, board->rowCount, line, first, last)) return -1;
+        if (spans_cross(board->colSpans, board->colCount, first, last, line)) return -1;
+    }
+
+    if (board->shipCount == board->shipCapacity) {
+        uint32_t capacity = board->shipCapacity == 0 ? SPARSE_FIRST_SHIPS : board->shipCapacity * 2;
+        sparse_ship_t* ships = realloc(board->ships, capacity * sizeof(sparse_ship_t));
+        if (ships == NULL) return -1;
+        board->ships = ships;
+        sparse_span_t* rowSpans = realloc(board->rowSpans, capacity * sizeof(sparse_span_t));
+        if (rowSpans == NULL) return -1;
+        board->rowSpans = rowSpans;
+        sparse_span_t* colSpans = realloc(board->colSpans, capacity * sizeof(sparse_span_t));
+        if (colSpans == NULL) return -1;
+        board->colSpans = colSpans;
+        board->shipCapacity = capacity;
+    }
+
+    uint32_t index = board->shipCount++;
+    board->ships[index] = (sparse_ship_t){.startx = x, .starty = y, .size = size, .hitPoints = size,
+                                          .orientation = orientation, .sunk = false};
+    sparse_span_t span = {.key = span_key(line, first), .end = last, .ship = index};
+    if (vertical) {
+        span_insert(board->colSpans, &board->colCount, span);
+    } else {
+        span_insert(board->rowSpans, &board->rowCount, span);
+    }
+    return index;
+}
+
+// Place a fleet at random
+int sparse_random_fleet(sparse_board_t* board, const uint32_t* sizes, uint32_t count, rng_t* rng) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t size = sizes[i];
+        // Positions each way, so the orientation is picked in proportion and every position is equally likely
+        uint64_t across = size > board->cols ? 0 : (uint64_t)board->rows * (board->cols - size + 1);
+        uint64_t down = size > board->rows || size == 1 ? 0 : (uint64_t)(board->rows - size + 1) * board->cols;
+        if (across + down == 0) return -1;
+
+        int placed = -1;
+        for (int tries = 0; tries < SPARSE_PLACE_TRIES && placed == -1; tries++) {
+            if (rng_next(rng) % (across + down) < across) {
+                uint32_t x = rng_below(rng, board->cols - size + 1) + 1;
+                placed = sparse_place(board, x, rng_below(rng, board->rows) + 1, size, HORIZONTAL);
+            } else {
+                uint32_t y = rng_below(rng, board->rows - size + 1) + 1;
+                placed = sparse_place(board, rng_below(rng, board->cols) + 1, y, size, VERTICAL);
+            }
+        }
+        if (placed == -1) return -1;
+    }
+    return 0;
+}
+
+// Apply a guess
+guess_result_t sparse_guess(sparse_board_t* board, uint32_t x, uint32_t y, int* ship) {
+    if (ship != NULL) *ship = NO_SHIP_INDEX;
+    if (x < 1 || x > board->cols || y < 1 || y > board->rows) return GUESS_INVALID;
+    if (shots_reserve(board) == -1) return GUESS_INVALID;
+    if (!shots_add(board->shots, board->shotCapacity, shot_key(board, x, y))) return GUESS_REPEATED;
+    board->shotCount++;
+
+    int index = sparse_ship_at(board, x, y);
+    if (index == NO_SHIP_INDEX) return GUESS_MISS;
+    if (ship != NULL) *ship = index;
+
+    sparse_ship_t* hit = &board->ships[index];
+    if (--hit->hitPoints > 0) return GUESS_HIT;
+    hit->sunk = true;
+    board->shipsSunk++;
+    return GUESS_SUNK;
+}
+
+// Check if a cell has been guessed
+bool sparse_guessed(const sparse_board_t* board, uint32_t x, uint32_t y) {
+    if (x < 1 || x > board->cols || y < 1 || y > board->rows) return false;
+    uint64_t key = shot_key(board, x, y);
+    for (uint64_t slot = shot_slot(key, board->shotCapacity);; slot = (slot + 1) & (board->shotCapacity - 1)) {
+        if (board->shots[slot] == key) return true;
+        if (board->shots[slot] == 0) return false;
+    }
+}
+
+// Forget every guess and repair every ship
+void sparse_clear_guesses(sparse_board_t* board) {
+    memset(board->shots, 0, board->shotCapacity * sizeof(uint64_t));
+    board->shotCount = 0;
+    for (uint32_t i = 0; i < board->shipCount; i++) {
+        board->ships[i].hitPoints = board->ships[i].size;
+        board->ships[i].sunk = false;
+    }
+    board->shipsSunk = 0;
+}
+
+// Check if every ship on a sparse board has sunk
+bool sparse_victory(const sparse_board_t* board) {
+    return board->shipCount > 0 && board->shipsSunk == board->shipCount;
+}
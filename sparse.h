@@ -0,0 +1,163 @@
+/**
+ * Massive boards - a sparse game board for sizes the bitboards in board.h can't hold, from
+ * 1000x1000 up to 100000x100000 with hundreds of ships.
+ *
+ * Nothing here is sized by the board's area. Each ship is an interval along its row (horizontal)
+ * or column (vertical), and the intervals are kept in two sorted arrays, one keyed by (row, start
+ * column) and one by (column, start row). Ships never overlap, so the ship on a cell is the one
+ * whose interval starts last before the cell on its row, or on its column: two binary searches.
+ * Shots go into an open-addressing hash set of cell numbers, and each ship counts down its own
+ * hit points, so a guess costs O(log ships) and a sunk or victory check is a counter compare.
+ * Memory grows with the number of ships and shots, never with rows * cols.
+ *
+ * The geometry is chosen at run time, unlike the compile-time ruleset of the dense board
+ * (rules.h). Coordinates are 1-indexed like everywhere else: x is the column, y the row.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "rng.h"
+
+#define SPARSE_MAX_SIDE 100000  // largest number of rows or columns
+
+/**
+ * sparse_ship struct, stores one ship on a sparse board
+ */
+typedef struct sparse_ship {
+    uint32_t startx;
+    uint32_t starty;
+    uint32_t size;
+    uint32_t hitPoints;             // cells of the ship not hit yet
+    enum Orientation orientation;
+    bool sunk;
+} sparse_ship_t;
+
+/**
+ * sparse_span struct, stores one ship's interval in a spatial index
+ */
+typedef struct sparse_span {
+    uint64_t key;   // line << 32 | first cell on the line (row and column for horizontal ships)
+    uint32_t end;   // last cell on the line
+    uint32_t ship;  // index in the board's ships
+} sparse_span_t;
+
+/**
+ * sparse_board struct, stores a massive board: its ships, their spatial index, and every shot
+ */
+typedef struct sparse_board {
+    uint32_t rows;
+    uint32_t cols;
+
+    sparse_ship_t* ships;
+    sparse_span_t* rowSpans;    // horizontal ships, sorted by key
+    sparse_span_t* colSpans;    // vertical ships, sorted by key
+    uint32_t shipCount;
+    uint32_t rowCount;
+    uint32_t colCount;
+    uint32_t shipCapacity;
+    uint32_t shipsSunk;
+
+    uint64_t* shots;            // hash set of guessed cell numbers + 1 (0 is an empty slot)
+    uint64_t shotCount;
+    uint64_t shotCapacity;      // slots, a power of two
+} sparse_board_t;
+
+/**
+ * Set up an empty sparse board
+ *
+ * @param board The board
+ * @param rows  Number of rows, 1..SPARSE_MAX_SIDE
+ * @param cols  Number of columns, 1..SPARSE_MAX_SIDE
+ * @return 0 on success, -1 if the size is out of range or memory ran out
+ */
+int sparse_board_init(sparse_board_t* board, uint32_t rows, uint32_t cols);
+
+/**
+ * Free everything a sparse board allocated (the board can be initialized again afterwards)
+ *
+ * @param board The board
+ */
+void sparse_board_free(sparse_board_t* board);
+
+/**
+ * Count the bytes a sparse board has allocated
+ *
+ * @param board The board
+ * @return The bytes, not counting the sparse_board_t itself
+ */
+size_t sparse_board_bytes(const sparse_board_t* board);
+
+/**
+ * Find the ship on a cell
+ *
+ * @param board The board
+ * @param x     Column, 1..cols
+ * @param y     Row, 1..rows
+ * @return The ship's index in board->ships, or NO_SHIP_INDEX if the cell is empty or off the board
+ */
+int sparse_ship_at(const sparse_board_t* board, uint32_t x, uint32_t y);
+
+/**
+ * Place a ship, if it stays on the board and misses every ship already placed
+ *
+ * @param board       The board
+ * @param x           Column of the first cell
+ * @param y           Row of the first cell
+ * @param size        Number of cells, at least 1
+ * @param orientation HORIZONTAL (the ship runs right) or VERTICAL (it runs down)
+ * @return The ship's index in board->ships, or -1 if it doesn't fit (or memory ran out)
+ */
+int sparse_place(sparse_board_t* board, uint32_t x, uint32_t y, uint32_t size, enum Orientation orientation);
+
+/**
+ * Place a fleet at random, each ship at a uniformly random position that misses the ones before it
+ *
+ * @param board The board, with no ships yet
+ * @param sizes Size of each ship
+ * @param count Number of ships
+ * @param rng   Random numbers (the same seed places the same fleet)
+ * @return 0 on success, -1 if a ship couldn't be placed (the board is too crowded)
+ */
+int sparse_random_fleet(sparse_board_t* board, const uint32_t* sizes, uint32_t count, rng_t* rng);
+
+/**
+ * Apply a guess: record the shot, and hit the ship on the cell if there is one
+ *
+ * @param board The board being shot at
+ * @param x     Column, 1..cols
+ * @param y     Row, 1..rows
+ * @param ship  Set to the index of the ship hit, or NO_SHIP_INDEX (may be NULL)
+ * @return What the guess did (GUESS_INVALID also if memory for the shot ran out)
+ */
+guess_result_t sparse_guess(sparse_board_t* board, uint32_t x, uint32_t y, int* ship);
+
+/**
+ * Check if a cell has been guessed
+ *
+ * @param board The board
+ * @param x     Column, 1..cols
+ * @param y     Row, 1..rows
+ * @return true if it has
+ */
+bool sparse_guessed(const sparse_board_t* board, uint32_t x, uint32_t y);
+
+/**
+ * Forget every guess and repair every ship, keeping the fleet where it is (a rematch on the same
+ * board). The shot set keeps its size, so a rematch doesn't allocate again.
+ *
+ * @param board The board
+ */
+void sparse_clear_guesses(sparse_board_t* board);
+
+/**
+ * Check if every ship on a sparse board has sunk
+ *
+ * @param board The board
+ * @return true if the fleet is gone (and at least one ship was placed)
+ */
+bool sparse_victory(const sparse_board_t* board);
@@ -0,0 +1,231 @@
+/**
+ * Sparse board cross-check - plays random small boards on both a sparse board (sparse.h) and a
+ * plain grid of ship numbers, and fails on the first place they disagree.
+ *
+ * Each board gets a random size, then random ships through sparse_place (accepted exactly when
+ * the ship stays on the board and misses every ship already on the grid) or a random fleet from
+ * sparse_random_fleet (whose ships have to land on empty grid cells). Every cell, and the cells just off each edge,
+ * is looked up with sparse_ship_at, and then every cell is shot at in random order, some twice,
+ * checking each guess result, the ship hit, sparse_guessed, hit points, and victory against the
+ * grid. The board is then cleared with sparse_clear_guesses and shot at again.
+ *
+ * Usage: battleship-sparse-check [boards] [seed]  (exits non-zero on the first mismatch)
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "rng.h"
+#include "sparse.h"
+
+#define MAX_SIDE 24             // largest number of rows or columns of a checked board
+#define MAX_SHIPS 64            // most ships placed on one board
+#define PLACE_ATTEMPTS 40       // random sparse_place calls per board
+#define EMPTY -1                // grid value of a cell without a ship
+
+/**
+ * grid struct, stores the plain model of a sparse board: the ship on every cell and each ship's hit points
+ */
+typedef struct grid {
+    uint32_t rows;
+    uint32_t cols;
+    int cells[MAX_SIDE + 2][MAX_SIDE + 2];  // [y][x], with an empty border around the board
+    int shipCount;
+    int hitPoints[MAX_SHIPS];
+    int sunk;
+    bool guessed[MAX_SIDE + 2][MAX_SIDE + 2];
+} grid_t;
+
+static unsigned long checks;    // comparisons made, for the report
+
+/**
+ * Stop with a message about the first mismatch
+ */
+#define CHECK(cond, ...)                                  \
+    do {                                                  \
+        checks++;                                         \
+        if (!(cond)) {                                    \
+            fprintf(stderr, "Mismatch: " __VA_ARGS__);    \
+            fprintf(stderr, "\n");                        \
+            exit(EXIT_FAILURE);                           \
+        }                                                 \
+    } while (0)
+
+/**
+ * Check whether a ship fits on the grid: on the board and on empty cells only
+ */
+static bool grid_fits(const grid_t* grid, uint32_t x, uint32_t y, uint32_t size, enum Orientation orientation) {
+    if (size < 1 || x < 1 || x > grid->cols || y < 1 || y > grid->rows) return false;
+    for (uint32_t i = 0; i < size; i++) {
+        uint32_t cx = orientation == HORIZONTAL ? x + i : x;
+        uint32_t cy = orientation == VERTICAL ? y + i : y;
+        if (cx > grid->cols || cy > grid->rows || grid->cells[cy][cx] != EMPTY) return false;
+    }
+    return true;
+}
+
+/**
+ * Put a ship on the grid
+ */
+static void grid_place(grid_t* grid, int index, uint32_t x, uint32_t y, uint32_t size, enum Orientation orientation) {
+    for (uint32_t i = 0; i < size; i++) {
+        uint32_t cx = orientation == HORIZONTAL ? x + i : x;
+        uint32_t cy = orientation == VERTICAL ? y + i : y;
+        CHECK(grid->cells[cy][cx] == EMPTY, "ship %d placed over ship %d at %u,%u", index, grid->cells[cy][cx], cx, cy);
+        grid->cells[cy][cx] = index;
+    }
+    grid->hitPoints[index] = size;
+}
+
+/**
+ * Check every ship the sparse board stores against the grid, and look up every cell and the
+ * cells just off the board
+ */
+static void check_layout(const sparse_board_t* board, const grid_t* grid) {
+    CHECK(board->shipCount == (uint32_t)grid->shipCount, "%u ships, expected %d", board->shipCount, grid->shipCount);
+    for (uint32_t y = 0; y <= grid->rows + 1; y++) {
+        for (uint32_t x = 0; x <= grid->cols + 1; x++) {
+            int ship = sparse_ship_at(board, x, y);
+            CHECK(ship == grid->cells[y][x], "sparse_ship_at(%u, %u) is %d, expected %d on %ux%u", x, y, ship,
+                  grid->cells[y][x], grid->cols, grid->rows);
+        }
+    }
+}
+
+/**
+ * Shoot at every cell in random order (and at some of them again), checking each result
+ */
+static void check_guesses(sparse_board_t* board, grid_t* grid, rng_t* rng) {
+    uint32_t order[MAX_SIDE * MAX_SIDE];
+    uint32_t count = grid->rows * grid->cols;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t j = rng_below(rng, i + 1);
+        order[i] = order[j];
+        order[j] = i;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t x = order[i] % grid->cols + 1, y = order[i] / grid->cols + 1;
+        // Now and then try a cell that was already shot at
+        if (i > 0 && rng_below(rng, 4) == 0) {
+            uint32_t old = order[rng_below(rng, i)];
+            uint32_t ox = old % grid->cols + 1, oy = old / grid->cols + 1;
+            int ship;
+            CHECK(sparse_guess(board, ox, oy, &ship) == GUESS_REPEATED, "repeated guess at %u,%u", ox, oy);
+            CHECK(ship == NO_SHIP_INDEX, "repeated guess at %u,%u named ship %d", ox, oy, ship);
+        }
+
+        CHECK(!sparse_guessed(board, x, y), "%u,%u guessed before it was shot at", x, y);
+        int ship;
+        guess_result_t result = sparse_guess(board, x, y, &ship);
+        grid->guessed[y][x] = true;
+        int expected = grid->cells[y][x];
+        guess_result_t want = GUESS_MISS;
+        if (expected != EMPTY) {
+            want = --grid->hitPoints[expected] == 0 ? GUESS_SUNK : GUESS_HIT;
+            if (want == GUESS_SUNK) grid->sunk++;
+        }
+        CHECK(result == want, "guess at %u,%u gave %d, expected %d", x, y, result, want);
+        CHECK(ship == expected, "guess at %u,%u hit ship %d, expected %d", x, y, ship, expected);
+        CHECK(sparse_guessed(board, x, y), "%u,%u not guessed after it was shot at", x, y);
+        if (expected != EMPTY) {
+            CHECK(board->ships[expected].hitPoints == (uint32_t)grid->hitPoints[expected], "ship %d hit points", expected);
+            CHECK(board->ships[expected].sunk == (grid->hitPoints[expected] == 0), "ship %d sunk flag", expected);
+        }
+        CHECK(board->shipsSunk == (uint32_t)grid->sunk, "%u ships sunk, expected %d", board->shipsSunk, grid->sunk);
+        CHECK(sparse_victory(board) == (grid->shipCount > 0 && grid->sunk == grid->shipCount), "victory after %u,%u", x, y);
+    }
+
+    // Off the board is never a shot
+    CHECK(sparse_guess(board, 0, 1, NULL) == GUESS_INVALID, "guess at column 0");
+    CHECK(sparse_guess(board, grid->cols + 1, 1, NULL) == GUESS_INVALID, "guess past the last column");
+    CHECK(sparse_guess(board, 1, grid->rows + 1, NULL) == GUESS_INVALID, "guess past the last row");
+    CHECK(board->shotCount == count, "%llu shots recorded, expected %u", (unsigned long long)board->shotCount, count);
+}
+
+/**
+ * Forget the grid's guesses and repair its ships, like sparse_clear_guesses
+ */
+static void grid_clear_guesses(grid_t* grid, const sparse_board_t* board) {
+    for (int i = 0; i < grid->shipCount; i++) grid->hitPoints[i] = board->ships[i].size;
+    for (uint32_t y = 0; y <= grid->rows + 1; y++) {
+        for (uint32_t x = 0; x <= grid->cols + 1; x++) grid->guessed[y][x] = false;
+    }
+    grid->sunk = 0;
+}
+
+/**
+ * Check one random board
+ */
+static void check_board(rng_t* rng) {
+    static grid_t grid;
+    grid = (grid_t){.rows = rng_below(rng, MAX_SIDE) + 1, .cols = rng_below(rng, MAX_SIDE) + 1};
+    for (uint32_t y = 0; y < MAX_SIDE + 2; y++) {
+        for (uint32_t x = 0; x < MAX_SIDE + 2; x++) grid.cells[y][x] = EMPTY;
+    }
+
+    sparse_board_t board;
+    CHECK(sparse_board_init(&board, grid.rows, grid.cols) == 0, "sparse_board_init(%u, %u)", grid.rows, grid.cols);
+
+    if (rng_below(rng, 2) == 0) {
+        // Ships at random positions, some off the board or over others
+        uint32_t longest = grid.rows > grid.cols ? grid.rows : grid.cols;
+        for (int i = 0; i < PLACE_ATTEMPTS && grid.shipCount < MAX_SHIPS; i++) {
+            uint32_t x = rng_below(rng, grid.cols + 2), y = rng_below(rng, grid.rows + 2);
+            uint32_t size = rng_below(rng, longest + 1) + (i % 8 == 0 ? 0 : 1);
+            enum Orientation orientation = rng_below(rng, 2) == 0 ? HORIZONTAL : VERTICAL;
+            bool fits = grid_fits(&grid, x, y, size, orientation);
+            int index = sparse_place(&board, x, y, size, orientation);
+            CHECK((index != -1) == fits, "sparse_place(%u, %u, size %u, %s) gave %d on %ux%u", x, y, size,
+                  orientation == HORIZONTAL ? "across" : "down", index, grid.cols, grid.rows);
+            if (index == -1) continue;
+            CHECK(index == grid.shipCount, "ship index %d, expected %d", index, grid.shipCount);
+            grid_place(&grid, grid.shipCount++, x, y, size, orientation);
+        }
+    } else {
+        // A random fleet, which may not fit (the ships it did place still have to be valid)
+        uint32_t sizes[MAX_SHIPS];
+        uint32_t count = rng_below(rng, MAX_SHIPS) + 1;
+        for (uint32_t i = 0; i < count; i++) sizes[i] = rng_below(rng, 5) + 1;
+        bool placed = sparse_random_fleet(&board, sizes, count, rng) == 0;
+        CHECK(!placed || board.shipCount == count, "random fleet has %u ships, expected %u", board.shipCount, count);
+        for (uint32_t i = 0; i < board.shipCount; i++) {
+            const sparse_ship_t* ship = &board.ships[i];
+            CHECK(ship->size == sizes[i], "random ship %u has size %u, expected %u", i, ship->size, sizes[i]);
+            CHECK(grid_fits(&grid, ship->startx, ship->starty, ship->size, ship->orientation),
+                  "random ship %u at %u,%u doesn't fit", i, ship->startx, ship->starty);
+            grid_place(&grid, grid.shipCount++, ship->startx, ship->starty, ship->size, ship->orientation);
+        }
+    }
+
+    check_layout(&board, &grid);
+    check_guesses(&board, &grid, rng);
+
+    // A rematch on the same fleet
+    sparse_clear_guesses(&board);
+    grid_clear_guesses(&grid, &board);
+    CHECK(board.shotCount == 0 && board.shipsSunk == 0 && !sparse_victory(&board), "cleared board");
+    check_layout(&board, &grid);
+    check_guesses(&board, &grid, rng);
+
+    sparse_board_free(&board);
+}
+
+int main(int argc, char* argv[]) {
+    long boards = argc > 1 ? atol(argv[1]) : 2000;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 10) : 1;
+    if (boards < 1) {
+        fprintf(stderr, "Usage: %s [boards] [seed]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    rng_t rng;
+    rng_seed(&rng, seed);
+    for (long i = 0; i < boards; i++) {
+        check_board(&rng);
+    }
+    printf("%ld sparse boards match the grid (%lu checks)\n", boards, checks);
+    return 0;
+}
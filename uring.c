@@ -0,0 +1,186 @@
+/**
+ * References for io_uring
+ *
+ * io_uring(7) and io_uring_setup(2) man pages
+ * Lord of the io_uring - https://unixism.net/loti/
+ */
+
+#ifdef HAVE_IO_URING
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "uring.h"
+
+// Create an io_uring instance and map its queues
+int uring_init(uring_t* ring, unsigned entries, unsigned cq_entries) {
+    memset(ring, 0, sizeof(uring_t));
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = cq_entries;
+
+    ring->fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd == -1) return -1;
+
+    // Map the submission ring, the completion ring (usually the same mapping), and the SQE array
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap && ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                         IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) goto fail;
+
+    if (single_mmap) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                             IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED) goto fail;
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                      IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) goto fail;
+
+    char* sq = ring->sq_ring;
+    ring->sq_entries = params.sq_entries;
+    ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->sq_local_tail = *ring->sq_tail;
+
+    // SQE slot i is always published through array slot i, so fill the indirection array once
+    for (unsigned i = 0; i < ring->sq_entries; i++) {
+        ring->sq_array[i] = i;
+    }
+
+    char* cq = ring->cq_ring;
+    ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return 0;
+
+fail:;
+    int saved = errno;
+    uring_exit(ring);
+    errno = saved;
+    return -1;
+}
+
+// Unmap the queues and close the ring
+void uring_exit(uring_t* ring) {
+    if (ring->sqes != NULL && ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != NULL && ring->cq_ring != MAP_FAILED && ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring != NULL && ring->sq_ring != MAP_FAILED) munmap(ring->sq_ring, ring->sq_ring_size);
+    if (ring->fd != -1) close(ring->fd);
+    ring->fd = -1;
+}
+
+// Get a zeroed submission queue entry, submitting queued entries first if the queue is full
+struct io_uring_sqe* uring_get_sqe(uring_t* ring) {
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (ring->sq_local_tail - head >= ring->sq_entries) {
+        if (uring_submit_and_wait(ring, 0) == -1) return NULL;
+        head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        if (ring->sq_local_tail - head >= ring->sq_entries) return NULL;
+    }
+
+    struct io_uring_sqe* sqe = &ring->sqes[ring->sq_local_tail & *ring->sq_mask];
+    ring->sq_local_tail++;
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    return sqe;
+}
+
+// Publish every prepared entry to the kernel and optionally wait for completions
+int uring_submit_and_wait(uring_t* ring, unsigned wait_nr) {
+    __atomic_store_n(ring->sq_tail, ring->sq_local_tail, __ATOMIC_RELEASE);
+
+    while (true) {
+        // Count from the kernel's head, not the tail published last time, so entries an earlier
+        // partial or failed enter left in the queue are submitted too
+        unsigned to_submit = ring->sq_local_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        if (to_submit == 0 && wait_nr == 0) return 0;
+
+        ring->enters++;
+        int rc = syscall(__NR_io_uring_enter, ring->fd, to_submit, wait_nr, wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0,
+                         NULL, 0);
+        // A signal during a wait goes back to the caller, which may have been asked to stop
+        if (rc == -1 && errno == EINTR && wait_nr == 0) continue;
+        return rc;
+    }
+}
+
+// Look at the oldest unhandled completion without waiting
+struct io_uring_cqe* uring_peek_cqe(uring_t* ring) {
+    unsigned head = *ring->cq_head;
+    if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) return NULL;
+    return &ring->cqes[head & *ring->cq_mask];
+}
+
+// Mark the completion returned by uring_peek_cqe as handled
+void uring_cqe_seen(uring_t* ring) {
+    __atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+// Register a ring of provided buffers for recv requests that use IOSQE_BUFFER_SELECT
+int uring_buf_ring_init(uring_t* ring, uring_buf_ring_t* br, unsigned entries, size_t buf_size, unsigned short bgid) {
+    memset(br, 0, sizeof(uring_buf_ring_t));
+    br->entries = entries;
+    br->bgid = bgid;
+    br->buf_size = buf_size;
+
+    // The ring itself must be page aligned, so map it; the buffers can live in the same mapping
+    br->ring_size = entries * sizeof(struct io_uring_buf) + entries * buf_size;
+    void* mem = mmap(NULL, br->ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) return -1;
+    br->ring = mem;
+    br->bufs = (uint8_t*)mem + entries * sizeof(struct io_uring_buf);
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (unsigned long)br->ring;
+    reg.ring_entries = entries;
+    reg.bgid = bgid;
+    if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        int saved = errno;
+        munmap(mem, br->ring_size);
+        errno = saved;
+        return -1;
+    }
+
+    // Hand every buffer to the kernel
+    for (unsigned i = 0; i < entries; i++) {
+        uring_buf_recycle(br, i);
+    }
+    return 0;
+}
+
+// Get the memory of a provided buffer the kernel filled
+uint8_t* uring_buf(uring_buf_ring_t* br, unsigned short bid) {
+    return br->bufs + (size_t)bid * br->buf_size;
+}
+
+// Hand a provided buffer back to the kernel once its data has been consumed
+void uring_buf_recycle(uring_buf_ring_t* br, unsigned short bid) {
+    unsigned short tail = br->ring->tail;
+    struct io_uring_buf* buf = &br->ring->bufs[tail & (br->entries - 1)];
+    buf->addr = (unsigned long)uring_buf(br, bid);
+    buf->len = br->buf_size;
+    buf->bid = bid;
+    __atomic_store_n(&br->ring->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * A thin io_uring layer over the raw system calls, just big enough for the match host: one
+ * submission/completion ring pair plus a ring of provided receive buffers for multishot recv.
+ *
+ * Only built when HAVE_IO_URING is defined (the Makefile does this on Linux).
+ */
+
+#pragma once
+
+#ifdef HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * uring struct, stores the mapped submission and completion queues of one io_uring instance
+ */
+typedef struct uring {
+    int fd;
+    unsigned sq_entries;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    unsigned sq_local_tail;     // SQEs handed out but not yet published to the kernel
+    struct io_uring_sqe* sqes;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+    unsigned long enters;       // io_uring_enter calls made, for syscall accounting
+} uring_t;
+
+/**
+ * uring_buf_ring struct, stores a group of equally sized receive buffers the kernel picks from
+ */
+typedef struct uring_buf_ring {
+    struct io_uring_buf_ring* ring;
+    size_t ring_size;
+    unsigned entries;
+    unsigned short bgid;
+    size_t buf_size;
+    uint8_t* bufs;
+} uring_buf_ring_t;
+
+/**
+ * Create an io_uring instance and map its queues
+ *
+ * @param ring       The ring to set up
+ * @param entries    Submission queue size
+ * @param cq_entries Completion queue size (multishot requests can produce many completions)
+ * @return 0 on success, -1 with errno set on failure
+ */
+int uring_init(uring_t* ring, unsigned entries, unsigned cq_entries);
+
+/**
+ * Unmap the queues and close the ring
+ *
+ * @param ring The ring to tear down
+ */
+void uring_exit(uring_t* ring);
+
+/**
+ * Get a zeroed submission queue entry, submitting queued entries first if the queue is full
+ *
+ * @param ring The ring
+ * @return The entry, or NULL if the queue is still full
+ */
+struct io_uring_sqe* uring_get_sqe(uring_t* ring);
+
+/**
+ * Publish every prepared entry to the kernel and optionally wait for completions, all in a
+ * single io_uring_enter. Entries the kernel didn't take last time (after a partial submit or a
+ * failure) are submitted again. A submit interrupted by a signal is retried; a wait isn't.
+ *
+ * @param ring    The ring
+ * @param wait_nr Number of completions to wait for (0 to just submit)
+ * @return Number of entries submitted, or -1 with errno set on failure (EINTR only while waiting)
+ */
+int uring_submit_and_wait(uring_t* ring, unsigned wait_nr);
+
+/**
+ * Look at the oldest unhandled completion without waiting
+ *
+ * @param ring The ring
+ * @return The completion, or NULL if there are none
+ */
+struct io_uring_cqe* uring_peek_cqe(uring_t* ring);
+
+/**
+ * Mark the completion returned by uring_peek_cqe as handled
+ *
+ * @param ring The ring
+ */
+void uring_cqe_seen(uring_t* ring);
+
+/**
+ * Register a ring of provided buffers for recv requests that use IOSQE_BUFFER_SELECT
+ *
+ * @param ring     The io_uring the buffers belong to
+ * @param br       The buffer ring to set up
+ * @param entries  Number of buffers (a power of two)
+ * @param buf_size Size of each buffer
+ * @param bgid     Buffer group id used in recv requests
+ * @return 0 on success, -1 with errno set on failure
+ */
+int uring_buf_ring_init(uring_t* ring, uring_buf_ring_t* br, unsigned entries, size_t buf_size, unsigned short bgid);
+
+/**
+ * Get the memory of a provided buffer the kernel filled
+ *
+ * @param br  The buffer ring
+ * @param bid Buffer id from the completion flags
+ * @return The buffer
+ */
+uint8_t* uring_buf(uring_buf_ring_t* br, unsigned short bid);
+
+/**
+ * Hand a provided buffer back to the kernel once its data has been consumed
+ *
+ * @param br  The buffer ring
+ * @param bid Buffer id from the completion flags
+ */
+void uring_buf_recycle(uring_buf_ring_t* br, unsigned short bid);
+
+#endif